@@ -15,6 +15,7 @@
 
 #include "RFM69.h"
 #include "RFM69Config.h"
+#include "prof.h"
 
 /**
  * Assert SS on the RFM69 for communications.
@@ -35,7 +36,7 @@ static uint8_t _mode;
  */
 bool rf69_init(void)
 {
-    uint8_t i;
+    uint8_t i, reg;
 
     /* Set up the SPI IO as appropriate */
     SPI_DDR |= SPI_SS | SPI_MOSI | SPI_SCK;
@@ -50,8 +51,8 @@ bool rf69_init(void)
     _delay_ms(10);
     
     // Set up device
-    for(i = 0; CONFIG[i][0] != 255; i++)
-        rf69_spiWrite(CONFIG[i][0], CONFIG[i][1]);
+    for(i = 0; (reg = pgm_read_byte(&CONFIG[i][0])) != 255; i++)
+        rf69_spiWrite(reg, pgm_read_byte(&CONFIG[i][1]));
     
     /* Set initial mode */
     _mode = RFM69_MODE_RX;
@@ -236,6 +237,60 @@ void rf69_setMode(const uint8_t newMode)
     _mode = newMode;
 }
 
+/**
+ * Set the node address. With address filtering on, the RFM69 drops any
+ * packet whose first byte after the length isn't this or the broadcast
+ * address, without raising PayloadReady.
+ * @param addr The node address
+ */
+void rf69_setAddress(const uint8_t addr)
+{
+    rf69_spiWrite(RFM69_REG_39_NODE_ADRS, addr);
+}
+
+/**
+ * Change the carrier frequency with one burst write of the FRF registers,
+ * which takes effect as the last is written.
+ * @param frf The three FRF register values, MSB first, in flash
+ */
+void rf69_setChannel(const uint8_t* frf)
+{
+    uint8_t buf[3], i;
+
+    for(i = 0; i < 3; i++)
+        buf[i] = pgm_read_byte(&frf[i]);
+    rf69_spiBurstWrite(RFM69_REG_07_FRF_MSB, buf, 3);
+}
+
+/**
+ * Load the AES key, which the RFM69 keeps until it loses power.
+ * @warning Must only be called in sleep or standby mode
+ * @param key The RFM69_AES_KEY_LEN byte key
+ */
+void rf69_setAesKey(const uint8_t* key)
+{
+    rf69_spiBurstWrite(RFM69_REG_3E_AESKEY1, key, RFM69_AES_KEY_LEN);
+}
+
+/**
+ * Turn AES on or off. With it on the RFM69 encrypts each packet it sends
+ * and decrypts each it receives with AES-128 in ECB mode, and pads the
+ * payload after any address byte to whole RFM69_AES_BLOCK_LEN blocks. The
+ * length and address bytes are sent in the clear. Packets must be at most
+ * 64 bytes.
+ * @param on true to turn AES on
+ */
+void rf69_setAes(bool on)
+{
+    uint8_t reg = rf69_spiRead(RFM69_REG_3D_PACKET_CONFIG2);
+
+    if(on)
+        reg |= RF_PACKET2_AES_ON;
+    else
+        reg &= ~RF_PACKET2_AES_ON;
+    rf69_spiWrite(RFM69_REG_3D_PACKET_CONFIG2, reg);
+}
+
 /**
  * Send a packet using the RFM69 radio.
  * @param data The data buffer that contains the string to transmit
@@ -255,6 +310,18 @@ void rf69_send(const uint8_t* data, uint8_t len, uint8_t power)
     }
 
     oldMode = _mode;
+
+#ifdef PROFILE
+    // Bring the oscillator up first, to time it separately from the PA
+    rf69_setMode(RFM69_MODE_STDBY);
+    // Bounded like the waits below, but polled without a delay so the
+    // time isn't rounded up to 5ms
+    timeout = 255;
+    while(!(rf69_spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_MODEREADY)
+            && timeout)
+        timeout--;
+    PROF_MARK(PROF_RADIO);
+#endif
     
     // Start Transmitter
     rf69_setMode(RFM69_MODE_TX);
@@ -285,6 +352,7 @@ void rf69_send(const uint8_t* data, uint8_t len, uint8_t power)
         _delay_ms(5);
         timeout--;
     }
+    PROF_MARK(PROF_PA);
 
 
     // Throw Buffer into FIFO, packet transmission will start automatically
@@ -299,6 +367,7 @@ void rf69_send(const uint8_t* data, uint8_t len, uint8_t power)
         _delay_ms(5);
         timeout--;
     }
+    PROF_MARK(PROF_AIR);
 
     // Return Transceiver to original mode
     rf69_setMode(oldMode);
@@ -402,3 +471,58 @@ int16_t rf69_sampleRssi(void)
 
     return lastRssi;
 }
+
+/**
+ * Listen for a single packet, for a bounded time. Uses the RFM69's RX
+ * timeouts, in units of 16 bit periods (8ms at 2kbps), so the radio can't
+ * be left receiving indefinitely. The radio is returned to its previous
+ * mode afterwards.
+ * @param buf The buffer for the packet, at least RFM69_MAX_MESSAGE_LEN long
+ * @param len Set to the length of the packet
+ * @param wait Give up if no signal is heard within this time
+ * @param rx Give up if no packet has arrived this long after a signal is
+ * first heard
+ * @returns true if a packet was received with a good CRC
+ */
+bool rf69_receiveWindow(uint8_t* buf, uint8_t* len, uint8_t wait, uint8_t rx)
+{
+    uint8_t oldMode, flags, n;
+    bool ok = false;
+
+    oldMode = _mode;
+
+    rf69_spiWrite(RFM69_REG_2A_RX_TIMEOUT1, wait);
+    rf69_spiWrite(RFM69_REG_2B_RX_TIMEOUT2, rx);
+    rf69_setMode(RFM69_MODE_RX);
+
+    // Leaving RX clears the timeout flag, so it's clear to start with
+    do {
+        _delay_ms(2);
+        flags = rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2);
+    } while(!(flags & RF_IRQFLAGS2_PAYLOADREADY)
+            && !(rf69_spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_TIMEOUT));
+
+    if(flags & RF_IRQFLAGS2_PAYLOADREADY)
+    {
+        RFM_SS_ASSERT();
+        spi_bb_xfer(RFM69_REG_00_FIFO);
+
+        // First byte is the packet length
+        n = spi_bb_xfer(0xFF);
+        if(n > RFM69_MAX_MESSAGE_LEN)
+            n = RFM69_MAX_MESSAGE_LEN;
+
+        *len = n;
+        while(n--)
+            *buf++ = spi_bb_xfer(0xFF);
+        RFM_SS_DEASSERT();
+        ok = true;
+    }
+
+    // Leave the timeouts off so they don't affect any other reception
+    rf69_setMode(oldMode);
+    rf69_spiWrite(RFM69_REG_2A_RX_TIMEOUT1, 0);
+    rf69_spiWrite(RFM69_REG_2B_RX_TIMEOUT2, 0);
+
+    return ok;
+}
@@ -39,6 +39,10 @@
 // Max number of octets the RFM69 FIFO can hold
 #define RFM69_FIFO_SIZE 64
 
+// With AES on, the payload after any address byte is sent in whole blocks
+#define RFM69_AES_KEY_LEN   16
+#define RFM69_AES_BLOCK_LEN 16
+
 #define RFM69_MODE_SLEEP    0x00 // 0.1uA
 #define RFM69_MODE_STDBY    0x04 // 1.25mA
 #define RFM69_MODE_RX       0x10 // 16mA
@@ -96,11 +100,13 @@
 // Sync values 1-8 go here
 #define RFM69_REG_37_PACKET_CONFIG1 0x37
 #define RFM69_REG_38_PAYLOAD_LENGTH 0x38
-// Node address, broadcast address go here
+#define RFM69_REG_39_NODE_ADRS      0x39
+#define RFM69_REG_3A_BROADCAST_ADRS 0x3A
 #define RFM69_REG_3B_AUTOMODES      0x3B
 #define RFM69_REG_3C_FIFO_THRESHOLD 0x3C
 #define RFM69_REG_3D_PACKET_CONFIG2 0x3D
-// AES Key 1-16 go here
+#define RFM69_REG_3E_AESKEY1        0x3E
+// AES Key 2-16 go here
 #define RFM69_REG_4E_TEMP1          0x4E
 #define RFM69_REG_4F_TEMP2          0x4F
 #define RFM69_REG_58_TEST_LNA       0x58
@@ -776,7 +782,12 @@ void rf69_spiBurstRead(const uint8_t reg, uint8_t* dest, uint8_t len);
 void rf69_spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len);
 void rf69_spiFifoWrite(const uint8_t* src, uint8_t len);
 void rf69_setMode(const uint8_t newMode);
+void rf69_setAddress(const uint8_t addr);
+void rf69_setChannel(const uint8_t* frf);
+void rf69_setAesKey(const uint8_t* key);
+void rf69_setAes(bool on);
 void rf69_send(const uint8_t* data, uint8_t len, uint8_t power);
+bool rf69_receiveWindow(uint8_t* buf, uint8_t* len, uint8_t wait, uint8_t rx);
 void rf69_clearFifo(void);
 int8_t rf69_readTemp(void);
 int16_t rf69_sampleRssi(void);
@@ -0,0 +1,154 @@
+/**
+ * Cycle counts for the firmware's hot paths, run under simavr by make bench.
+ *
+ * Builds the firmware's own main.c and modules into an image that times
+ * each hot path with Timer1 clocked straight from the CPU, so that a tick
+ * is a cycle, and prints a line for each on simavr's console:
+ *
+ *     cycles <name> <n>
+ *
+ * There is no RFM69 or DS18B20 in the simulator. MISO is driven high so
+ * that every register the radio reads back as 0xff, which makes rf69_send()
+ * see TXREADY and PACKETSENT on its first poll, and so times the SPI
+ * traffic for a packet without the air time. The 1-wire line reads back
+ * low, which costs the same cycles as real data. The count for a path
+ * therefore only changes when its code does.
+ *
+ * Not for PROFILE builds, which use Timer1 themselves.
+ */
+
+#include <stdint.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "avr_mcu_section.h"
+
+#ifdef PROFILE
+#error "make bench with PROFILE=0"
+#endif
+
+/* The firmware, with its main() out of the way so its statics and
+ * build_beacon() can be used here */
+#define main firmware_main
+#include "../main.c"
+#undef main
+
+AVR_MCU(F_CPU, "attiny44");
+AVR_MCU_SIMAVR_CONSOLE(&GPIOR0);
+
+uint8_t ds18b20_readbyte(void);
+
+/* Timer1 overflows since bench_start() */
+static volatile uint16_t overflows;
+
+/* Cycles taken by bench_start() and bench_stop() themselves */
+static uint32_t overhead;
+
+/* A typical beacon */
+static const char beacon[] = "1bV1234T21.5X5,10,1,0,3[JH9]";
+
+/**
+ * Start counting cycles.
+ */
+static void bench_start(void)
+{
+    TCCR1B = 0;
+    TCNT1 = 0;
+    overflows = 0;
+    TIFR1 = _BV(TOV1);
+    TCCR1B = _BV(CS10);
+}
+
+/**
+ * Stop counting cycles.
+ * @returns The cycles since bench_start(), less the cost of timing
+ */
+static uint32_t bench_stop(void)
+{
+    uint32_t n;
+
+    TCCR1B = 0;
+
+    /* An overflow may not have been serviced yet if interrupts were off */
+    cli();
+    n = ((uint32_t)overflows << 16) | TCNT1;
+    if(TIFR1 & _BV(TOV1))
+        n += 0x10000UL;
+    sei();
+
+    return n - overhead;
+}
+
+/**
+ * Write a string to simavr's console.
+ * @param s The string
+ */
+static void bench_puts(const char* s)
+{
+    while(*s)
+        GPIOR0 = *s++;
+}
+
+/**
+ * Print the cycle count for a hot path.
+ * @param name The name the baseline knows it by
+ * @param n The cycle count
+ */
+static void bench_report(const char* name, uint32_t n)
+{
+    char buf[11];
+
+    bench_puts("cycles ");
+    bench_puts(name);
+    bench_puts(" ");
+    bench_puts(ultoa(n, buf, 10));
+    bench_puts("\n");
+}
+
+int main(void)
+{
+    PRR &= ~_BV(PRTIM1);
+    TIMSK1 = _BV(TOIE1);
+    sei();
+
+    bench_start();
+    overhead = 0;
+    overhead = bench_stop();
+
+    /* Pins as the firmware sets them up, but with MISO driven high */
+    SPI_DDR |= SPI_SS | SPI_MOSI | SPI_SCK | SPI_MISO;
+    SPI_PORT |= SPI_SS | SPI_MISO;
+    SPI_PORT &= ~SPI_SCK;
+
+    bench_start();
+    spi_bb_xfer(0xa5);
+    bench_report("spi_bb_xfer", bench_stop());
+
+    bench_start();
+    rf69_send((const uint8_t*)beacon, sizeof(beacon) - 1, TX_POWER_DBM);
+    bench_report("rf69_send", bench_stop());
+
+    bench_start();
+    ds18b20_readbyte();
+    bench_report("ds18b20_readbyte", bench_stop());
+
+    batt_mv = 1234;
+    seqid = 'b';
+    bench_start();
+    build_beacon(21.5);
+    bench_report("build_beacon", bench_stop());
+
+    /* simavr exits when the CPU sleeps with interrupts off */
+    cli();
+    sleep_enable();
+    sleep_cpu();
+
+    return 0;
+}
+
+ISR(TIM1_OVF_vect)
+{
+    overflows++;
+}
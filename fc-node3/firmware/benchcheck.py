@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Flash and cycle regression check for the fc-node3 image.
+
+Compares the flash taken by each function in the image, and the cycles
+taken by each hot path in the bench image (see bench/bench.c) under simavr,
+against a committed baseline. Anything that has grown by more than the
+tolerance makes the check fail, so that a change which costs flash or
+awake time has to be looked at and the baseline updated on purpose.
+
+Function sizes come from the symbol table, which has one entry per
+function since the firmware is built with -ffunction-sections. Functions
+that are new or gone since the baseline are listed but don't fail the
+check on their own, as the total does.
+
+The baseline is a text file of lines like
+
+    flash <function> <bytes>
+    cycles <path> <cycles>
+
+and is written with --update. --summary just prints the total flash and
+the cycle counts, for comparing build options.
+
+Usage: benchcheck.py [--tolerance percent] [--update | --summary]
+                     [--baseline file] main.elf bench.elf
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+SIMAVR = ['simavr', '-m', 'attiny44', '-f', '1000000']
+
+# simavr may wrap console lines in its own tag and colour codes
+CYCLES_RE = re.compile(r'cycles (\S+) (\d+)')
+
+
+def flash_sizes(elf):
+    """Map function name to bytes of flash, plus the total."""
+    out = subprocess.run(['avr-nm', '--size-sort', '-S', '-t', 'd', elf],
+                         check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True)
+    sizes = {}
+    for line in out.stdout.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in 'tTwW':
+            sizes[fields[3]] = int(fields[1])
+
+    out = subprocess.run(['avr-size', '-A', elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True)
+    total = 0
+    for line in out.stdout.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in ('.text', '.data'):
+            total += int(fields[1])
+    sizes['(total)'] = total
+    return sizes
+
+
+def cycle_counts(elf):
+    """Map hot path name to cycles, from running the bench image."""
+    out = subprocess.run(SIMAVR + [elf], check=True, timeout=60,
+                         stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                         universal_newlines=True)
+    counts = {}
+    for m in CYCLES_RE.finditer(out.stdout):
+        counts[m.group(1)] = int(m.group(2))
+    if not counts:
+        sys.exit('no cycle counts from ' + elf + ':\n' + out.stdout)
+    return counts
+
+
+def read_baseline(path):
+    """Map (kind, name) to the baseline value."""
+    base = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                fields = line.split()
+                if len(fields) == 3 and not line.startswith('#'):
+                    base[(fields[0], fields[1])] = int(fields[2])
+    except FileNotFoundError:
+        sys.exit(path + ' not found, make bench-baseline to create it from '
+                 'the default build and commit it')
+    return base
+
+
+def write_baseline(path, now):
+    with open(path, 'w') as f:
+        f.write('# fc-node3 flash (bytes) and cycle baseline, see '
+                'benchcheck.py\n')
+        for kind in ('flash', 'cycles'):
+            for (k, name) in sorted(now):
+                if k == kind:
+                    f.write('%s %s %d\n' % (kind, name, now[(k, name)]))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('--tolerance', type=float, default=2.0)
+    ap.add_argument('--update', action='store_true')
+    ap.add_argument('--summary', action='store_true')
+    ap.add_argument('--baseline', default='bench.txt')
+    ap.add_argument('elf')
+    ap.add_argument('bench_elf')
+    args = ap.parse_args()
+
+    now = {}
+    for name, n in flash_sizes(args.elf).items():
+        now[('flash', name)] = n
+    for name, n in cycle_counts(args.bench_elf).items():
+        now[('cycles', name)] = n
+
+    if args.summary:
+        for (kind, name) in sorted(now):
+            if kind == 'cycles' or name == '(total)':
+                print('  %-6s %-24s %8d' % (kind, name, now[(kind, name)]))
+        return 0
+
+    if args.update:
+        write_baseline(args.baseline, now)
+        print('wrote ' + args.baseline)
+        return 0
+
+    base = read_baseline(args.baseline)
+    failed = False
+
+    print('%-6s %-28s %8s %8s %7s' % ('', 'name', 'base', 'now', 'change'))
+    for key in sorted(set(base) | set(now)):
+        kind, name = key
+        b, n = base.get(key), now.get(key)
+        if b is None:
+            note = 'new'
+        elif n is None:
+            note = 'gone'
+        elif n == b:
+            continue
+        else:
+            pct = 100.0 * (n - b) / b if b else float('inf')
+            note = '%+6.1f%%' % pct
+            if pct > args.tolerance:
+                note += '  FAIL'
+                failed = True
+        print('%-6s %-28s %8s %8s %s' % (kind, name,
+              '-' if b is None else b, '-' if n is None else n, note))
+
+    if failed:
+        print('FAIL: grown by more than %g%%, make bench-baseline if that '
+              'is intended' % args.tolerance)
+        return 1
+    print('OK: within %g%% of %s' % (args.tolerance, args.baseline))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,46 @@
+/**
+ * Channel plan.
+ * See chanplan.h.
+ */
+
+#include <stdint.h>
+
+#include <avr/pgmspace.h>
+
+#include "RFM69.h"
+
+#include "chanplan.h"
+
+/* FRF = f / (32MHz / 2^19), MSB first */
+static const uint8_t frf[CHAN_COUNT][3] PROGMEM =
+{
+    { 0xD9, 0x60, 0x12 },   // 869.500MHz, the UKHASnet carrier
+    { 0xD9, 0x5C, 0xDF },   // 869.450MHz
+    { 0xD9, 0x63, 0x45 },   // 869.550MHz
+    { 0xD9, 0x66, 0x78 },   // 869.600MHz
+};
+
+/**
+ * Move the radio to a channel.
+ * @param ch The channel, less than CHAN_COUNT
+ */
+void chan_set(uint8_t ch)
+{
+    rf69_setChannel(frf[ch]);
+}
+
+/**
+ * Pick a channel for a node from its ID, so that nodes are spread evenly
+ * across the plan but each always uses the same one.
+ * @param node_id The node ID
+ * @returns The channel
+ */
+uint8_t chan_by_id(const char* node_id)
+{
+    uint8_t h = 0;
+
+    while(*node_id)
+        h = h * 31 + (uint8_t)*node_id++;
+
+    return h % CHAN_COUNT;
+}
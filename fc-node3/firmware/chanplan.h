@@ -0,0 +1,33 @@
+/**
+ * Channel plan.
+ *
+ * Every node normally beacons on the UKHASnet carrier, channel 0, so in a
+ * dense area they all compete for the same air. The plan adds channels in
+ * the rest of the 869.4-869.65MHz sub-band, 50kHz apart, which is about
+ * twice the occupied bandwidth of the 2kbps signal. Nodes can be given a
+ * channel each, spread across the plan by node ID, or pick one at random
+ * for each beacon. Gateways then need a receiver per channel, each with an
+ * RX bandwidth narrow enough to reject its neighbours, or fewer nodes will
+ * be heard rather than more.
+ *
+ * The FRF register values for each channel are worked out in advance and
+ * kept in flash, so changing channel is one burst write to the RFM69. They
+ * carry the same trim as the carrier in RFM69Config.h.
+ */
+
+#ifndef __CHANPLAN_H__
+#define __CHANPLAN_H__
+
+#include <stdint.h>
+
+/* Number of channels in the plan */
+#define CHAN_COUNT      4
+
+/* Special values of CHANNEL in main.c */
+#define CHAN_BY_ID      0xfe
+#define CHAN_RANDOM     0xff
+
+void chan_set(uint8_t ch);
+uint8_t chan_by_id(const char* node_id);
+
+#endif /* __CHANPLAN_H__ */
@@ -0,0 +1,72 @@
+/**
+ * Compact binary beacons.
+ * See compact.h.
+ */
+
+#include <stdint.h>
+
+#include "compact.h"
+
+/**
+ * Write the flag and the packed word at the start of a compact beacon.
+ * @param p Where the beacon starts
+ * @param hops The hop count
+ * @param seqid The sequence ID, 'a' to 'z'
+ * @param mv The battery voltage in mV
+ * @param temp The temperature in 0.1degC
+ * @returns Where the next field goes
+ */
+uint8_t* compact_pack(uint8_t* p, uint8_t hops, char seqid, uint16_t mv,
+        int16_t temp)
+{
+    uint32_t w;
+    uint8_t i;
+
+    if(mv > COMPACT_MV_MAX)
+        mv = COMPACT_MV_MAX;
+    if(temp < -COMPACT_TEMP_OFFSET)
+        temp = -COMPACT_TEMP_OFFSET;
+    else if(temp > COMPACT_TEMP_MAX)
+        temp = COMPACT_TEMP_MAX;
+
+    w = (hops & 0x0f)
+        | ((uint32_t)((seqid - 'a') & 0x1f) << 4)
+        | ((uint32_t)mv << 9)
+        | ((uint32_t)(temp + COMPACT_TEMP_OFFSET) << 21);
+
+    *p++ = COMPACT_FLAG;
+    for(i = 0; i < 4; i++)
+    {
+        *p++ = (uint8_t)w;
+        w >>= 8;
+    }
+
+    return p;
+}
+
+/**
+ * Read the packed word at the start of a compact beacon.
+ * @param p Where the beacon starts, which must be COMPACT_FLAG
+ * @param hops The hop count
+ * @param seqid The sequence ID
+ * @param mv The battery voltage in mV
+ * @param temp The temperature in 0.1degC
+ * @returns Where the next field is
+ */
+const uint8_t* compact_unpack(const uint8_t* p, uint8_t* hops, char* seqid,
+        uint16_t* mv, int16_t* temp)
+{
+    uint32_t w = 0;
+    uint8_t i;
+
+    p++;
+    for(i = 0; i < 4; i++)
+        w |= (uint32_t)*p++ << (8 * i);
+
+    *hops = w & 0x0f;
+    *seqid = 'a' + ((w >> 4) & 0x1f);
+    *mv = (w >> 9) & 0x0fff;
+    *temp = (int16_t)((w >> 21) & 0x07ff) - COMPACT_TEMP_OFFSET;
+
+    return p;
+}
@@ -0,0 +1,61 @@
+/**
+ * Compact binary beacons, built with COMPACT defined in main.c.
+ *
+ * A text beacon like 1bV1432T21.5X5,10,1,0,3[JH9] spends most of its air
+ * time on ASCII. A compact beacon carries the same fields bit packed, in
+ * 13 bytes for a three letter node ID instead of 28, and a gateway expands
+ * it back into the text beacon before passing it on (see
+ * ../../gateway/telemetry.h). Text packets always start with the hop count
+ * digit, so COMPACT_FLAG as the first byte marks a compact one.
+ *
+ * Byte   Contents
+ * 0      COMPACT_FLAG
+ * 1-4    A little endian word of
+ *            bits 0-3    hops
+ *            bits 4-8    sequence ID - 'a'
+ *            bits 9-20   battery voltage in mV
+ *            bits 21-31  temperature in 0.1degC + COMPACT_TEMP_OFFSET
+ * 5      wake_freq
+ * 6      tx_power in bits 0-4, power_mode in bit 5, and COMPACT_FUEL and
+ *        COMPACT_STACK if those fields follow
+ * 7      brown-out resets
+ * 8-9    boots, little endian
+ * 10-12  COMPACT_FUEL only: sleep current in nA (little endian) and wake
+ *        interval std dev in % of mean
+ * ..     COMPACT_STACK only: stack headroom in bytes, up to 255
+ * ..     The node ID, to the end of the packet
+ *
+ * Repeaters don't understand compact beacons, so only gateways in direct
+ * range of the node will hear them.
+ *
+ * This file is also used by the gateway, so keep it to portable C.
+ */
+
+#ifndef __COMPACT_H__
+#define __COMPACT_H__
+
+#include <stdint.h>
+
+/* First byte of a compact beacon, which can't start a text one */
+#define COMPACT_FLAG        0xfc
+
+/* Length of the fixed part, up to the optional fields */
+#define COMPACT_LEN         10
+
+/* Byte 6 */
+#define COMPACT_POWER_MASK  0x1f
+#define COMPACT_MODE        0x20
+#define COMPACT_FUEL        0x40
+#define COMPACT_STACK       0x80
+
+/* Field limits, values outside them are clamped */
+#define COMPACT_MV_MAX      4095
+#define COMPACT_TEMP_OFFSET 600
+#define COMPACT_TEMP_MAX    (2047 - COMPACT_TEMP_OFFSET)
+
+uint8_t* compact_pack(uint8_t* p, uint8_t hops, char seqid, uint16_t mv,
+        int16_t temp);
+const uint8_t* compact_unpack(const uint8_t* p, uint8_t* hops, char* seqid,
+        uint16_t* mv, int16_t* temp);
+
+#endif /* __COMPACT_H__ */
@@ -0,0 +1,184 @@
+/**
+ * Over the air parameter updates.
+ * See downlink.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+
+#include "RFM69.h"
+
+#include "downlink.h"
+#include "xtea.h"
+
+/* RX timeouts are in units of 16 bits at 2kbps */
+#define DOWNLINK_UNIT_MS    8
+
+cfg_t cfg;
+
+#ifdef DOWNLINK_AES
+static const uint8_t aes_key[RFM69_AES_KEY_LEN] PROGMEM = DOWNLINK_AES_KEY;
+#else
+static const uint32_t key[4] PROGMEM = DOWNLINK_KEY;
+#endif
+
+static cfg_t EEMEM ee_cfg[DOWNLINK_SLOTS];
+
+/* The slot holding cfg */
+static uint8_t slot = DOWNLINK_SLOTS - 1;
+
+/**
+ * @param c The record
+ * @returns The check byte for the record
+ */
+static uint8_t cfg_check(const cfg_t* c)
+{
+    const uint8_t* p = (const uint8_t*)c;
+    uint8_t i, sum = 0xa5;
+
+    for(i = 0; i < offsetof(cfg_t, check); i++)
+        sum += p[i];
+
+    return sum;
+}
+
+/**
+ * Apply an authentic update if it's newer than the last, and save it.
+ * @param c The update, which is changed
+ * @returns true if cfg was changed
+ */
+static bool apply(cfg_t* c)
+{
+    if(c->ctr <= cfg.ctr || c->ctr == 0xffff || !c->freq
+            || c->power < 2 || c->power > 20)
+        return false;
+
+    c->check = cfg_check(c);
+    if(++slot == DOWNLINK_SLOTS)
+        slot = 0;
+    eeprom_update_block(c, &ee_cfg[slot], sizeof(cfg_t));
+    cfg = *c;
+
+    return true;
+}
+
+/**
+ * Work out a node's radio address from its ID.
+ * @param node_id The node ID
+ * @returns The address
+ */
+uint8_t downlink_address(const char* node_id)
+{
+    uint8_t h = 0;
+
+    while(*node_id)
+        h = h * 31 + (uint8_t)*node_id++;
+
+    return DOWNLINK_ADDR_BASE | (h & 0x3f);
+}
+
+/**
+ * Set the radio's address and AES key, and replace the values in cfg with
+ * the last update from EEPROM, if there is one. Set cfg to the defaults
+ * first.
+ * @param node_id The node ID
+ */
+void downlink_init(const char* node_id)
+{
+    cfg_t c;
+    uint8_t i;
+
+    rf69_setAddress(downlink_address(node_id));
+
+#ifdef DOWNLINK_AES
+    {
+        uint8_t k[RFM69_AES_KEY_LEN];
+        memcpy_P(k, aes_key, sizeof(k));
+        rf69_setAesKey(k);
+    }
+#endif
+
+    cfg.ctr = 0;
+
+    for(i = 0; i < DOWNLINK_SLOTS; i++)
+    {
+        eeprom_read_block(&c, &ee_cfg[i], sizeof(c));
+        if(c.ctr != 0xffff && c.ctr > cfg.ctr && c.check == cfg_check(&c))
+        {
+            cfg = c;
+            slot = i;
+        }
+    }
+}
+
+#ifdef DOWNLINK_AES
+/**
+ * Listen for an update and apply it if it's for us and authentic.
+ * @param node_id The node ID
+ * @param buf A buffer for the frame, RFM69_MAX_MESSAGE_LEN long
+ * @returns true if cfg was changed
+ */
+bool downlink_listen(const char* node_id, uint8_t* buf)
+{
+    uint8_t id[DOWNLINK_AES_ID_LEN];
+    uint8_t len, n;
+    bool heard;
+    cfg_t* c = (cfg_t*)&buf[3];
+
+    rf69_setAes(true);
+    heard = rf69_receiveWindow(buf, &len, DOWNLINK_WAIT / DOWNLINK_UNIT_MS,
+                DOWNLINK_RX / DOWNLINK_UNIT_MS);
+    rf69_setAes(false);
+
+    // The radio has already checked the address byte and decrypted the rest
+    n = strlen(node_id);
+    memset(id, 0, sizeof(id));
+    memcpy(id, node_id, n < sizeof(id) ? n : sizeof(id));
+    if(!heard || len != 1 + RFM69_AES_BLOCK_LEN
+            || buf[1] != ':' || buf[2] != 'C'
+            || memcmp(&buf[3 + sizeof(cfg_t)], id, sizeof(id)))
+        return false;
+
+    return apply(c);
+}
+#else
+/**
+ * Listen for an update and apply it if it's for us and authentic.
+ * @param node_id The node ID
+ * @param buf A buffer for the frame, RFM69_MAX_MESSAGE_LEN long
+ * @returns true if cfg was changed
+ */
+bool downlink_listen(const char* node_id, uint8_t* buf)
+{
+    uint8_t msg[2 * XTEA_BLOCK_LEN];
+    uint8_t len, n;
+    cfg_t* c = (cfg_t*)&msg[XTEA_BLOCK_LEN];
+
+    if(!rf69_receiveWindow(buf, &len, DOWNLINK_WAIT / DOWNLINK_UNIT_MS,
+                DOWNLINK_RX / DOWNLINK_UNIT_MS))
+        return false;
+
+    // The radio has already checked the address byte
+    n = strlen(node_id);
+    if(len != 4 + n + sizeof(cfg_t) + DOWNLINK_MAC_LEN
+            || buf[1] != ':' || buf[2] != 'C'
+            || memcmp(&buf[3], node_id, n) || buf[3 + n] != ',')
+        return false;
+
+    memset(msg, 0, XTEA_BLOCK_LEN);
+    memcpy(msg, node_id, n < XTEA_BLOCK_LEN ? n : XTEA_BLOCK_LEN);
+    memcpy(c, &buf[4 + n], sizeof(cfg_t));
+
+    // The frame is finished with, so work out the MAC in its place
+    xtea_mac(key, msg, 2, buf);
+    if(memcmp(buf, &buf[4 + n + sizeof(cfg_t)], DOWNLINK_MAC_LEN))
+        return false;
+
+    return apply(c);
+}
+#endif
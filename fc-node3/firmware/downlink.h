@@ -0,0 +1,101 @@
+/**
+ * Over the air parameter updates.
+ *
+ * After each beacon the node listens briefly for a frame from a gateway
+ * carrying new values for the beacon rate, TX power and MODE_WDT threshold
+ * and hysteresis. The window is closed by the RFM69's own RX timeouts, so
+ * it costs at most DOWNLINK_WAIT ms of receive current when nothing is sent,
+ * and DOWNLINK_WAIT + DOWNLINK_RX if something is heard.
+ *
+ * A frame is
+ *
+ *     <address>:C<NODE_ID>,<cfg_t><MAC>
+ *
+ * where the address is the node's radio address (see downlink_address()) or
+ * DOWNLINK_BROADCAST, the cfg_t is sent little endian with check set to 0, and the MAC is
+ * the first DOWNLINK_MAC_LEN bytes of the XTEA CBC-MAC of the node ID,
+ * zero padded or truncated to 8 bytes, followed by the cfg_t. The counter
+ * must be greater than that of the last update accepted, which stops old
+ * frames being replayed. The address byte is never a digit, so UKHASnet
+ * repeaters ignore the frames. fc-node3/host/fc-cfg builds them.
+ *
+ * Built with make DOWNLINK_AES=1, the MAC is left to the RFM69's AES engine
+ * instead, so the MCU does no crypto at all. The frame is then
+ *
+ *     <address><block>
+ *
+ * where the 16 byte block is ":C", the cfg_t as above and the node ID,
+ * zero padded or truncated to 6 bytes, encrypted by the gateway's RFM69
+ * with DOWNLINK_AES_KEY. The node's RFM69 decrypts it, and a block that was
+ * tampered with or encrypted with another key decrypts to noise that fails
+ * the check on ":C" and the node ID. The frame fits in exactly one block,
+ * so AES adds no air time over the plain frame, and the whole frame is 2
+ * bytes shorter than the XTEA one for a three letter node ID. The node only
+ * has AES on while it listens, so its beacons are sent in the clear.
+ *
+ * The RFM69 filters on the address, so packets from other nodes and frames
+ * for other nodes are dropped by the radio and the window carries on
+ * listening, rather than ending it with a frame the MCU has to read and
+ * throw away. Packets with a bad CRC are dropped the same way.
+ *
+ * Accepted updates are kept in a ring of DOWNLINK_SLOTS records in EEPROM,
+ * each written to the slot after the last, so that each slot only wears at
+ * 1/DOWNLINK_SLOTS of the update rate. At boot the valid record with the
+ * highest counter wins, and a record torn by a reset while it was being
+ * written fails its check byte and is skipped.
+ */
+
+#ifndef __DOWNLINK_H__
+#define __DOWNLINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The MAC key, change this for each deployment */
+#define DOWNLINK_KEY    { 0x01234567, 0x89abcdef, 0xfedcba98, 0x76543210 }
+
+/* The AES key for DOWNLINK_AES, change this for each deployment */
+#define DOWNLINK_AES_KEY    { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, \
+                              0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c }
+
+/* Bytes of the node ID in the DOWNLINK_AES block */
+#define DOWNLINK_AES_ID_LEN 6
+
+/* Listen for up to DOWNLINK_WAIT ms for the gateway to start sending, then
+ * up to DOWNLINK_RX ms for the frame. Both are rounded down to 8ms. */
+#define DOWNLINK_WAIT   96
+#define DOWNLINK_RX     200
+
+/* Number of records in the EEPROM ring */
+#define DOWNLINK_SLOTS  8
+
+/* Bytes of the MAC sent */
+#define DOWNLINK_MAC_LEN    4
+
+/* Radio addresses are DOWNLINK_ADDR_BASE plus 6 bits of a hash of the node
+ * ID, which keeps them clear of the digits that start UKHASnet packets and
+ * the flag bytes of compact.h and history.h. Frames to DOWNLINK_BROADCAST
+ * reach every node, which still checks the node ID. */
+#define DOWNLINK_ADDR_BASE  0x80
+#define DOWNLINK_BROADCAST  0xff
+
+/**
+ * Parameters that can be changed over the air.
+ */
+typedef struct cfg_t {
+    uint16_t ctr;           // Counter, increases with each update
+    uint8_t freq;           // WAKE_FREQ
+    uint8_t power;          // TX_POWER_DBM
+    uint16_t thresh;        // POWER_MODE_WDT_THRESH
+    uint8_t hyst;           // POWER_MODE_WDT_HYST
+    uint8_t check;          // Check byte for the EEPROM record
+} cfg_t;
+
+/* The parameters in use */
+extern cfg_t cfg;
+
+uint8_t downlink_address(const char* node_id);
+void downlink_init(const char* node_id);
+bool downlink_listen(const char* node_id, uint8_t* buf);
+
+#endif /* __DOWNLINK_H__ */
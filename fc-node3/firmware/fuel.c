@@ -0,0 +1,125 @@
+/**
+ * Reservoir capacitor fuel gauge.
+ * See fuel.h.
+ */
+
+#include <stdint.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+
+#include "fuel.h"
+
+/* Charge drawn from C1 per interval, scaled for intervals in ticks*16 and
+ * a result in nA */
+#define FUEL_CHARGE ((uint32_t)FUEL_RES_UF * FUEL_SWING_MV * 1000UL * 16)
+
+/* Longest interval counted, which keeps the arithmetic in range */
+#define FUEL_MAX_TICKS  2047
+
+volatile uint16_t fuel_ticks;
+
+/* Mean interval in ticks*16, 0 before the first sample */
+static uint16_t mean;
+
+/* Variance of the interval in (ticks*16)^2 */
+static uint32_t var;
+
+/**
+ * Start timing the interval until the next INT0 wake. Call immediately
+ * before disabling the regulator and going to sleep.
+ */
+void fuel_start(void)
+{
+    cli();
+    fuel_ticks = 0;
+    wdt_reset();
+
+    /* Interrupt only mode, so the watchdog keeps running after each tick */
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | FUEL_WDP;
+}
+
+/**
+ * Stop timing and add the interval to the running statistics. Call with
+ * interrupts disabled, as soon as INT0 has woken the node.
+ */
+void fuel_stop(void)
+{
+    uint16_t x;
+    int16_t d;
+
+    wdt_disable();
+
+    /* Count the partial tick as half of one */
+    x = fuel_ticks;
+    if(x > FUEL_MAX_TICKS)
+        x = FUEL_MAX_TICKS;
+    x = (x << 4) + 8;
+
+    if(!mean)
+    {
+        mean = x;
+        return;
+    }
+
+    d = (int16_t)(x - mean);
+    mean += d >> FUEL_SHIFT;
+    var += (uint32_t)((int32_t)d * d) >> FUEL_SHIFT;
+    var -= var >> FUEL_SHIFT;
+}
+
+/**
+ * Estimate the load on C1 while the node is asleep, excluding the gauge.
+ * @returns The sleep current in nA, or 0 before the first interval
+ */
+uint16_t fuel_current(void)
+{
+    uint32_t i;
+
+    if(!mean)
+        return 0;
+
+    i = FUEL_CHARGE / ((uint32_t)mean * FUEL_TICK_MS);
+    if(i <= FUEL_WDT_NA)
+        return 0;
+    i -= FUEL_WDT_NA;
+
+    return i > 0xffff ? 0xffff : (uint16_t)i;
+}
+
+/**
+ * How much the interval varies from wake to wake.
+ * @returns The standard deviation of the interval as a percentage of the
+ * mean, or 0 before the first interval
+ */
+uint8_t fuel_spread(void)
+{
+    uint32_t sd = 0;
+    uint32_t bit = 1UL << 30;
+    uint32_t v = var;
+
+    if(!mean)
+        return 0;
+
+    /* Integer square root */
+    while(bit > v)
+        bit >>= 2;
+    while(bit)
+    {
+        if(v >= sd + bit)
+        {
+            v -= sd + bit;
+            sd = (sd >> 1) + bit;
+        }
+        else
+        {
+            sd >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    sd = (sd * 100) / mean;
+    return sd > 255 ? 255 : (uint8_t)sd;
+}
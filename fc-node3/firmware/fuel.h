@@ -0,0 +1,50 @@
+/**
+ * Reservoir capacitor fuel gauge.
+ *
+ * In MODE_BOOSTOFF the regulator is off while the node sleeps and C1 alone
+ * supplies the load, until it has fallen from the regulator's output to the
+ * detection voltage of U3 and INT0 fires. The length of that interval
+ * therefore measures the sleep current directly:
+ *
+ *     I = C1 * (VREG - VDET) / t
+ *
+ * Timer1 stops in power down, so intervals are timed by counting watchdog
+ * interrupts. The watchdog oscillator costs a few uA, which is about as much
+ * as the node itself draws asleep, so it only runs for one interval after
+ * each beacon and its own draw is subtracted from the estimate. The
+ * watchdog oscillator is only good to about 10% and drifts with temperature
+ * and supply, so treat the estimate as a relative figure between nodes and
+ * over time rather than an absolute one.
+ *
+ * A running mean and variance of the interval are kept as exponentially
+ * weighted averages over roughly the last 2^FUEL_SHIFT samples.
+ */
+
+#ifndef __FUEL_H__
+#define __FUEL_H__
+
+#include <stdint.h>
+
+/* C1 (uF) and the swing from the regulator output to U3's threshold (mV) */
+#define FUEL_RES_UF     100
+#define FUEL_SWING_MV   (3300 - 2500)
+
+/* Watchdog tick, must match FUEL_WDP */
+#define FUEL_TICK_MS    250
+#define FUEL_WDP        (_BV(WDP2))
+
+/* Power down current with the watchdog running, less without (nA) */
+#define FUEL_WDT_NA     4000
+
+/* Averaging weight of each new sample is 1/2^FUEL_SHIFT */
+#define FUEL_SHIFT      3
+
+/* Watchdog ticks in the interval being timed, counted by WATCHDOG_vect */
+extern volatile uint16_t fuel_ticks;
+
+void fuel_start(void);
+void fuel_stop(void);
+uint16_t fuel_current(void);
+uint8_t fuel_spread(void);
+
+#endif /* __FUEL_H__ */
@@ -0,0 +1,101 @@
+/**
+ * Telemetry history frames.
+ * See history.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "history.h"
+
+/* Samples, with the newest at head - 1 */
+static uint16_t mv[HISTORY_LEN];
+static int16_t temp[HISTORY_LEN];
+static uint8_t head;
+static uint8_t count;
+
+/* Beacons since the last frame */
+static uint8_t beacons;
+
+/**
+ * Forget the samples kept, when the next beacon won't follow on from the
+ * last.
+ */
+void history_reset(void)
+{
+    count = 0;
+}
+
+/**
+ * Keep a beacon's readings.
+ * @param batt_mv The battery voltage in mV
+ * @param t The temperature in 0.1degC
+ * @returns true if it is time to send a frame
+ */
+bool history_add(uint16_t batt_mv, int16_t t)
+{
+    mv[head] = batt_mv;
+    temp[head] = t;
+    head = (head + 1) % HISTORY_LEN;
+    if(count < HISTORY_LEN)
+        count++;
+
+    if(++beacons < HISTORY_EVERY)
+        return false;
+    beacons = 0;
+    return true;
+}
+
+/**
+ * Write a difference as a zig-zag varint.
+ * @param p Where to write it
+ * @param d The difference
+ * @returns Where the next byte goes
+ */
+static uint8_t* put_delta(uint8_t* p, int16_t d)
+{
+    uint16_t z = ((uint16_t)d << 1) ^ (uint16_t)(d >> 15);
+
+    while(z >= 0x80)
+    {
+        *p++ = (uint8_t)z | 0x80;
+        z >>= 7;
+    }
+    *p++ = (uint8_t)z;
+
+    return p;
+}
+
+/**
+ * Write a history frame of the samples kept, up to the node ID.
+ * @param p Where the frame starts, with room for HISTORY_HEADER_LEN plus
+ * 6 bytes per sample
+ * @param hops The hop count
+ * @param seqid The sequence ID of the newest sample's beacon
+ * @returns Where the node ID goes
+ */
+uint8_t* history_frame(uint8_t* p, uint8_t hops, char seqid)
+{
+    uint8_t i, n, prev;
+
+    n = (head + HISTORY_LEN - 1) % HISTORY_LEN;
+
+    *p++ = HISTORY_FLAG;
+    *p++ = hops;
+    *p++ = seqid;
+    *p++ = count;
+    *p++ = (uint8_t)mv[n];
+    *p++ = (uint8_t)(mv[n] >> 8);
+    *p++ = (uint8_t)temp[n];
+    *p++ = (uint8_t)((uint16_t)temp[n] >> 8);
+
+    for(i = 1; i < count; i++)
+    {
+        prev = n;
+        n = (n + HISTORY_LEN - 1) % HISTORY_LEN;
+        p = put_delta(p, (int16_t)(mv[n] - mv[prev]));
+        p = put_delta(p, (int16_t)((uint16_t)temp[n] - (uint16_t)temp[prev]));
+    }
+
+    return p;
+}
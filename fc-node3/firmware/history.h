@@ -0,0 +1,53 @@
+/**
+ * Telemetry history frames, built with HISTORY defined in main.c.
+ *
+ * The node keeps the battery voltage and temperature from its last
+ * HISTORY_LEN beacons, and every HISTORY_EVERY beacons sends them all in a
+ * binary frame after the beacon. A gateway that missed a few beacons can
+ * fill in the series from the next frame it hears (see
+ * ../../gateway/telemetry.h). Samples change slowly, so after the newest
+ * each is sent as the difference from the one after it, zig-zag encoded so
+ * that small negative differences are small too, as a base 128 varint.
+ * Most take one byte each.
+ *
+ * Byte   Contents
+ * 0      HISTORY_FLAG
+ * 1      hops
+ * 2      sequence ID of the newest sample's beacon
+ * 3      number of samples
+ * 4-5    newest battery voltage in mV, little endian
+ * 6-7    newest temperature in 0.1degC, little endian
+ * ..     for each older sample, newest first: varints of the voltage and
+ *        temperature differences, older - newer, modulo 2^16
+ * ..     The node ID, to the end of the packet
+ *
+ * Samples are from consecutive beacons, so the decoder counts sequence IDs
+ * back from the newest, 'b' following 'z'. The history starts empty at
+ * boot and after anything else takes sequence IDs, like the profiler's
+ * packets, and the 'a' beacon sent at boot isn't kept since the next one
+ * doesn't follow on from it.
+ *
+ * The samples take 4 bytes of RAM each.
+ */
+
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* First byte of a history frame, which can't start a text packet */
+#define HISTORY_FLAG        0xfd
+
+/* Samples kept, and send them every HISTORY_EVERY beacons */
+#define HISTORY_LEN         8
+#define HISTORY_EVERY       4
+
+/* Length of the header before the varints */
+#define HISTORY_HEADER_LEN  8
+
+void history_reset(void);
+bool history_add(uint16_t mv, int16_t temp);
+uint8_t* history_frame(uint8_t* p, uint8_t hops, char seqid);
+
+#endif /* __HISTORY_H__ */
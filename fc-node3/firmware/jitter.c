@@ -0,0 +1,98 @@
+/**
+ * Wake jitter, to stop nodes beaconing in lockstep.
+ * See jitter.h.
+ */
+
+#include <stdint.h>
+
+#include <avr/io.h>
+
+#include "jitter.h"
+
+/* Internal temperature sensor against the 1.1V reference */
+#define JITTER_ADMUX    (_BV(REFS1) | 0x22)
+
+/* xorshift state, never 0 */
+static uint16_t state;
+
+/**
+ * @returns The next pseudo-random number
+ */
+static uint16_t jitter_rand(void)
+{
+    state ^= state << 7;
+    state ^= state >> 9;
+    state ^= state << 8;
+    return state;
+}
+
+/**
+ * Seed the PRNG. Hashes the node ID together with the bottom bits of a run
+ * of conversions of the internal temperature sensor, which are noisy.
+ * @param node_id The node ID
+ */
+void jitter_init(const char* node_id)
+{
+    uint8_t i;
+
+    while(*node_id)
+        state = (state << 5) + (state >> 11) + *node_id++;
+
+    PRR &= ~_BV(PRADC);
+    ADMUX = JITTER_ADMUX;
+    for(i = 0; i < 16; i++)
+    {
+        // Writing ADIF back clears it
+        ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADIF) | _BV(ADPS1) | _BV(ADPS0);
+        while(!(ADCSRA & _BV(ADIF)));
+        state = (state << 1 | state >> 15) ^ ADC;
+    }
+
+    // Leave the ADC as get_batt_voltage() expects to find it
+    ADCSRA = _BV(ADIF);
+    ADMUX = 0;
+    PRR |= _BV(PRADC);
+
+    if(!state)
+        state = 1;
+}
+
+/**
+ * @param wake_freq The mean number of INT0 wakes per beacon
+ * @returns The number of INT0 wakes until the next beacon
+ */
+uint8_t jitter_wakes(uint8_t wake_freq)
+{
+#if JITTER_WAKES
+    int16_t n;
+
+    n = wake_freq + (uint8_t)jitter_rand() % (2 * JITTER_WAKES + 1)
+        - JITTER_WAKES;
+    if(n < 1)
+        return 1;
+    if(n > 255)
+        return 255;
+    return n;
+#else
+    return wake_freq;
+#endif
+}
+
+/**
+ * @returns A watchdog timeout (WDTO_15MS to WDTO_15MS + JITTER_WDT) for the
+ * extra sleep
+ */
+uint8_t jitter_wdt(void)
+{
+    return (uint8_t)jitter_rand() % (JITTER_WDT + 1);
+}
+
+/**
+ * Pick one of a number of things at random.
+ * @param n How many there are
+ * @returns 0 to n - 1
+ */
+uint8_t jitter_pick(uint8_t n)
+{
+    return (uint8_t)jitter_rand() % n;
+}
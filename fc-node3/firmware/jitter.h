@@ -0,0 +1,32 @@
+/**
+ * Wake jitter, to stop nodes beaconing in lockstep.
+ *
+ * Nodes built alike wake at nearly the same rate, so two that happen to
+ * beacon together keep colliding for hours. A small PRNG, seeded from the
+ * node ID and ADC noise so that no two nodes share a sequence, varies each
+ * beacon interval a little around the configured one. The jitter never
+ * shortens the mean interval, so it costs no extra energy.
+ *
+ * Larger values break collisions up sooner at the cost of a less regular
+ * beacon interval. Set both to 0 to disable jitter.
+ */
+
+#ifndef __JITTER_H__
+#define __JITTER_H__
+
+#include <stdint.h>
+
+/* Vary the INT0 wakes per beacon in MODE_BOOSTOFF by up to +/-JITTER_WAKES */
+#define JITTER_WAKES    1
+
+/* Add a random sleep to each MODE_WDT wake, of a watchdog timeout from
+ * WDTO_15MS up to WDTO_15MS + JITTER_WDT (0-7), each doubling the last, so
+ * up to WDTO_1S by default. 0 leaves the extra sleep out. */
+#define JITTER_WDT      6
+
+void jitter_init(const char* node_id);
+uint8_t jitter_wakes(uint8_t wake_freq);
+uint8_t jitter_wdt(void);
+uint8_t jitter_pick(uint8_t n);
+
+#endif /* __JITTER_H__ */
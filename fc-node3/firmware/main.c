@@ -9,6 +9,14 @@
  * falls below POWER_MODE_WDT_THRESH, the reg is left enabled and the device
  * sleeps on the watchdog timer in order to maximally drain the cell.
  *
+ * The brown-out detector is enabled by the fuses at 1.8V, below U3's
+ * threshold so that waking on a nearly empty reservoir doesn't trip it, and
+ * switched off with BODS for each sleep. It only costs current while awake
+ * and catches the reservoir sagging too far during a transmission.
+ *
+ * Boots, brown-out resets and the sequence ID survive resets in EEPROM (see
+ * nvlog.h), so gateways can tell a reboot from lost packets.
+ *
  * Jon Sowman 2015-18
  * jon+github@jonsowman.com
  *
@@ -29,6 +37,16 @@
 #include "RFM69Config.h"
 
 #include "ds18b20.h"
+#include "sched.h"
+#include "fuel.h"
+#include "jitter.h"
+#include "downlink.h"
+#include "nvlog.h"
+#include "prof.h"
+#include "stack.h"
+#include "compact.h"
+#include "history.h"
+#include "chanplan.h"
 
 /* Node configuration options */
 #define NODE_ID         "JH9"
@@ -36,6 +54,31 @@
 #define WAKE_FREQ       5
 #define TX_POWER_DBM    10
 
+/* Channel to beacon on (see chanplan.h), 0 for the UKHASnet carrier.
+ * CHAN_BY_ID spreads nodes across the plan by NODE_ID and CHAN_RANDOM picks
+ * one at random for each beacon. */
+#define CHANNEL         0
+
+/* Uncomment on nodes with a panel on the SOLAR header, to adapt WAKE_FREQ
+ * and TX_POWER_DBM to the energy harvested (see sched.h) */
+/* #define SOLAR */
+
+/* Uncomment to time the sleep after each beacon and report the current
+ * drawn while asleep (see fuel.h) */
+/* #define FUEL_GAUGE */
+
+/* Uncomment to listen for parameter updates from a gateway after each
+ * beacon (see downlink.h) */
+/* #define DOWNLINK */
+
+/* Uncomment to send beacons in binary, for gateways that can expand them
+ * (see compact.h) */
+/* #define COMPACT */
+
+/* Uncomment to send the readings from the last few beacons now and then,
+ * so gateways can fill in the ones they missed (see history.h) */
+/* #define HISTORY */
+
 /* Move into MODE_WDT when the battery voltage falls below (mV) */
 #define POWER_MODE_WDT_THRESH  1350
 #define POWER_MODE_WDT_HYST      50
@@ -64,12 +107,38 @@ typedef enum power_mode_t {
     NUM_POWER_MODES
 } power_mode_t;
 
-/* Starting sequence ID */
+/* Starting sequence ID, and the one to carry on from after it */
 static char seqid = 'a';
+static char resume_seqid;
 
 /* How many times have we woken up? */
 static uint8_t wakes = WAKE_FREQ;
 
+/* How many wakes until the next beacon, wake_freq with jitter */
+static uint8_t beacon_wakes = WAKE_FREQ;
+
+/* Parameters, which can be changed over the air on DOWNLINK nodes */
+#ifdef DOWNLINK
+#define cfg_wake_freq   cfg.freq
+#define cfg_tx_power    cfg.power
+#define wdt_thresh      cfg.thresh
+#define wdt_hyst        cfg.hyst
+#else
+#define cfg_wake_freq   WAKE_FREQ
+#define cfg_tx_power    TX_POWER_DBM
+#define wdt_thresh      POWER_MODE_WDT_THRESH
+#define wdt_hyst        POWER_MODE_WDT_HYST
+#endif
+
+/* Beacon rate and power, which the scheduler adjusts on SOLAR nodes */
+#ifdef SOLAR
+#define wake_freq   sched_wake_freq
+#define tx_power    sched_tx_power
+#else
+#define wake_freq   cfg_wake_freq
+#define tx_power    cfg_tx_power
+#endif
+
 /* UKHASnet packet buffer and pointer */
 static char packetbuf[64];
 static char *p;
@@ -81,19 +150,48 @@ static power_mode_t power_mode = MODE_BOOSTOFF;
 /* Get the voltage on the battery terminals in mV */
 uint16_t get_batt_voltage(void);
 float get_temperature(void);
+static uint8_t build_beacon(float temp);
+#ifdef COMPACT
+static uint8_t build_compact(float temp);
+#endif
+#if defined(COMPACT) || defined(HISTORY)
+static int16_t temp_deci(float temp);
+#endif
+#ifdef HISTORY
+static void send_history(void);
+#endif
+static void next_seqid(void);
+#ifdef PROFILE
+static void send_profile(void);
+#endif
 
 /* Main loop */
 int main(void)
 {
-    /* Disable watchdog */
+    uint8_t reset_flags, len;
+    float temp;
+
+    /* Find out why we reset and disable the watchdog, which can't be
+     * done until WDRF is cleared */
+    reset_flags = MCUSR;
+    MCUSR = 0;
     wdt_disable();
 
+#ifdef PROFILE
+    prof_init();
+#endif
+
     /* Enable global interrupts */
     sei();
 
     /* Wait for cap to charge */
     _delay_ms(1000);
 
+    /* Restore the counters and count this boot, and any brown-out but
+     * not the one that can accompany power on */
+    resume_seqid = nvlog_boot(
+            (reset_flags & (_BV(BORF) | _BV(PORF))) == _BV(BORF));
+
     /* EN pin should be 0 */
     EN_PORT &= ~_BV(EN_PIN);
     
@@ -111,97 +209,129 @@ int main(void)
     while(!rf69_init());
     rf69_setMode(RFM69_MODE_SLEEP);
 
+#ifdef DOWNLINK
+    /* Use the last update received, if there's been one */
+    cfg.freq = WAKE_FREQ;
+    cfg.power = TX_POWER_DBM;
+    cfg.thresh = POWER_MODE_WDT_THRESH;
+    cfg.hyst = POWER_MODE_WDT_HYST;
+    downlink_init(NODE_ID);
+#endif
+
+#ifdef SOLAR
+    sched_init(get_batt_voltage(), cfg_wake_freq, cfg_tx_power);
+#endif
+
+    /* Make this node's wake sequence different to its neighbours' */
+    jitter_init(NODE_ID);
+
+#if CHANNEL == CHAN_BY_ID
+    chan_set(chan_by_id(NODE_ID));
+#elif CHANNEL != CHAN_RANDOM && CHANNEL >= CHAN_COUNT
+#error "CHANNEL is not in the channel plan"
+#elif CHANNEL != CHAN_RANDOM && CHANNEL != 0
+    chan_set(CHANNEL);
+#endif
+
     /* All periphs off */
     PRR |= _BV(PRTIM0) | _BV(PRUSI) | _BV(PRADC);
+    PROF_MARK(PROF_BOOT);
 
     /* Main loop of sleeping and transmitting */
     while(1)
     {
         /* Wakes will be roughly every 30sec depending on exact hardware 
          * and climate conditions */
-        if(wakes == WAKE_FREQ)
+        if(wakes >= beacon_wakes)
         {
-            /* Construct and send the packet. A packet looks like
-             <HOPS><SEQID>VxxxxTyy.yXa,b,c[<NODEID>]
-            where:
-            <HOPS> is as defined at top of this file
-            <SEQID> is a sequence ID, 'a' at startup, running 'b'-'z' after
-            Vxxxx is the battery voltage in millivolts
-            Tyy.y is the temperature in decimal degrees 
-            Xa,b,c is a custom field:
-                a: WAKE_FREQ
-                b: TX_POWER_DBM
-                c: power_mode (0=MODE_WDT, 1=MODE_BOOSTOFF)
-            <NODEID> is as configured at the top of this file
-            */
-            /* Reset pointer to beginning of packet buffer */
-            p = packetbuf;
-
-            /* Number of hops */
-            strcpy(p, HOPS);
-            p += strlen(p);
-
-            /* Add sequence ID */
-            *p++ = seqid;
-
-            /* Add voltage */
-            *p++ = 'V';
+#ifdef PROFILE
+            prof_begin();
+#endif
+
+            /* Take the readings */
             batt_mv = get_batt_voltage();
-            utoa(batt_mv, p, 10);
-            p += strlen(p);
-
-            /* Add temperature */
-            *p++ = 'T';
-            dtostrf(get_temperature(), 1, 1, p);
-            p += strlen(p);
-
-            /* Add wake freq, tx power and power save mode */
-            *p++ = 'X';
-            utoa(WAKE_FREQ, p, 10);
-            p += strlen(p);
-            *p++ = ',';
-            utoa(TX_POWER_DBM, p, 10);
-            p += strlen(p);
-            *p++ = ',';
-            utoa(power_mode, p, 10);
-            p += strlen(p);
-
-            /* Add node ID in [] */
-            *p++ = '[';
-            strcpy(p, NODE_ID);
-            p += strlen(p);
-            *p++ = ']';
-
-            /* Null terminate */
-            *p = '\0';
+            PROF_MARK(PROF_ADC);
+            temp = get_temperature();
+            PROF_MARK(PROF_DS18B20);
+
+            /* Construct the packet */
+#ifdef COMPACT
+            len = build_compact(temp);
+#else
+            len = build_beacon(temp);
+#endif
+            PROF_MARK(PROF_BUILD);
 
             /* Send the packet */
-            rf69_send((uint8_t*)packetbuf, strlen(packetbuf), TX_POWER_DBM); 
+#if CHANNEL == CHAN_RANDOM
+            chan_set(jitter_pick(CHAN_COUNT));
+#endif
+            rf69_send((uint8_t*)packetbuf, len, tx_power);
 
             /* Delay to allow the cap to recharge a bit extra after tx,
              * since it takes a little while after rf69_send() exits
              * for the PA to fully turn off and stop drawing current */
             _delay_ms(10);
 
-            /* Reset the number of wakes */
-            wakes = 1;
+#ifdef DOWNLINK
+            /* Give a gateway the chance to send new parameters */
+            if(downlink_listen(NODE_ID, (uint8_t*)packetbuf))
+            {
+#ifdef SOLAR
+                sched_init(batt_mv, cfg.freq, cfg.power);
+#endif
+            }
+#endif
+
+#ifdef HISTORY
+            /* Keep the readings, and send the last few now and then */
+            if(seqid != 'a' && history_add(batt_mv, temp_deci(temp)))
+            {
+                /* Its RADIO, PA and AIR marks aren't the beacon's */
+#ifdef PROFILE
+                prof_suspend();
+#endif
+                send_history();
+#ifdef PROFILE
+                prof_resume();
+#endif
+            }
+#endif
+
+#ifdef SOLAR
+            /* Reschedule from the charge used since the last beacon. In
+             * MODE_WDT wakes are timed rather than metered, so leave it. */
+            if( power_mode == MODE_BOOSTOFF )
+                sched_update(batt_mv, wakes);
+#endif
 
             /* Increase the sequence ID for the next time we enter here */
-            if(seqid == 'z')
-                seqid = 'b';
-            else
-                seqid++;
+            next_seqid();
+
+            /* Count the beacon, and save the counters now and then */
+            nvlog_beacon(seqid, wakes);
+
+            /* Reset the number of wakes */
+            wakes = 1;
+            beacon_wakes = jitter_wakes(wake_freq);
 
             /* Update the power mode */
             if( power_mode == MODE_BOOSTOFF 
-                    && batt_mv < POWER_MODE_WDT_THRESH )
+                    && batt_mv < wdt_thresh )
                 /* Battery fallen below threshold, move to MODE_WDT */
                 power_mode = MODE_WDT;
             else if( power_mode == MODE_WDT 
-                    && batt_mv > (POWER_MODE_WDT_THRESH + POWER_MODE_WDT_HYST) )
+                    && batt_mv > (wdt_thresh + wdt_hyst) )
                 /* Battery is above (threshold+hysteresis), move to 
                  * MODE_BOOSTOFF. */
                 power_mode = MODE_BOOSTOFF;
+
+#ifdef PROFILE
+            /* The rest of the way to sleep is negligible */
+            prof_end();
+            if(prof_due())
+                send_profile();
+#endif
         } /* End of the waking loop - go back to sleep */
         else
         {
@@ -219,11 +349,26 @@ int main(void)
             // And sleep ZzZzZ
             set_sleep_mode(SLEEP_MODE_PWR_DOWN);
             sleep_enable();
-            // turn off reg and sleep
-            REG_DISABLE();
-            sei();
-            sleep_cpu();
+#ifdef FUEL_GAUGE
+            // Time the first sleep after each beacon
+            if(wakes == 1)
+                fuel_start();
+#endif
+            // turn off reg and sleep until INT0 turns it back on, since
+            // the fuel gauge's watchdog ticks wake us too
             cli();
+            REG_DISABLE();
+            while(EN_DDR & _BV(EN_PIN))
+            {
+                sleep_bod_disable();
+                sei();
+                sleep_cpu();
+                cli();
+            }
+#ifdef FUEL_GAUGE
+            if(wakes == 1)
+                fuel_stop();
+#endif
             GIMSK = 0x00;
             sleep_disable();
 
@@ -233,11 +378,14 @@ int main(void)
             /* Enable the watchdog and sleep for 8 seconds */
             set_sleep_mode(SLEEP_MODE_PWR_DOWN);
             sleep_enable();
-            /* 8x8 = 64 seconds which is roughly one 'wake' */
-            for(uint8_t sleeps = 0; sleeps < 8; sleeps++)
+            /* 8x8 = 64 seconds which is roughly one 'wake', plus a random
+             * short sleep to keep out of step with other nodes */
+            for(uint8_t sleeps = 0; sleeps < (JITTER_WDT ? 9 : 8); sleeps++)
             {
-                wdt_enable(WDTO_8S);
+                wdt_enable(sleeps < 8 ? WDTO_8S : jitter_wdt());
                 WDTCSR |= (1 << WDIE);
+                sleep_bod_disable();
+                sei();
                 sleep_cpu();
             }
             sleep_disable();
@@ -247,6 +395,233 @@ int main(void)
     return 0;
 } /* Main application loop -- never leave here */
 
+/**
+ * Construct a beacon in packetbuf. A packet looks like
+ *     <HOPS><SEQID>VxxxxTyy.yXa,b,c,d,e[,f,g][<NODEID>]
+ * where:
+ * <HOPS> is as defined at top of this file
+ * <SEQID> is a sequence ID, 'a' at startup, running 'b'-'z' after and
+ *     carrying on across resets
+ * Vxxxx is the battery voltage in millivolts
+ * Tyy.y is the temperature in decimal degrees
+ * Xa,b,c,d,e is a custom field:
+ *     a: WAKE_FREQ (as scheduled on SOLAR nodes)
+ *     b: TX_POWER_DBM (as scheduled on SOLAR nodes)
+ *     c: power_mode (0=MODE_WDT, 1=MODE_BOOSTOFF)
+ *     d: brown-out resets
+ *     e: boots
+ *     f: sleep current in nA (FUEL_GAUGE only)
+ *     g: wake interval std dev in % of mean (FUEL_GAUGE only)
+ * <NODEID> is as configured at the top of this file
+ * @param temp The temperature in degrees C, batt_mv is used for the voltage
+ * @returns The length of the packet
+ */
+static uint8_t build_beacon(float temp)
+{
+    /* Reset pointer to beginning of packet buffer */
+    p = packetbuf;
+
+    /* Number of hops */
+    strcpy(p, HOPS);
+    p += strlen(p);
+
+    /* Add sequence ID */
+    *p++ = seqid;
+
+    /* Add voltage */
+    *p++ = 'V';
+    utoa(batt_mv, p, 10);
+    p += strlen(p);
+
+    /* Add temperature */
+    *p++ = 'T';
+    dtostrf(temp, 1, 1, p);
+    p += strlen(p);
+
+    /* Add wake freq, tx power, power save mode, brown-outs and boots */
+    *p++ = 'X';
+    utoa(wake_freq, p, 10);
+    p += strlen(p);
+    *p++ = ',';
+    utoa(tx_power, p, 10);
+    p += strlen(p);
+    *p++ = ',';
+    utoa(power_mode, p, 10);
+    p += strlen(p);
+    *p++ = ',';
+    utoa(nvlog.bod_resets, p, 10);
+    p += strlen(p);
+    *p++ = ',';
+    utoa(nvlog.boots, p, 10);
+    p += strlen(p);
+#ifdef FUEL_GAUGE
+    *p++ = ',';
+    utoa(fuel_current(), p, 10);
+    p += strlen(p);
+    *p++ = ',';
+    utoa(fuel_spread(), p, 10);
+    p += strlen(p);
+#endif
+
+#ifdef STACKPAINT
+    /* Add the least stack headroom there's been */
+    *p++ = ':';
+    *p++ = 'S';
+    utoa(stack_headroom(), p, 10);
+    p += strlen(p);
+#endif
+
+    /* Add node ID in [] */
+    *p++ = '[';
+    strcpy(p, NODE_ID);
+    p += strlen(p);
+    *p++ = ']';
+
+    /* Null terminate */
+    *p = '\0';
+
+    return p - packetbuf;
+}
+
+#ifdef COMPACT
+/**
+ * Construct the binary form of a beacon in packetbuf (see compact.h).
+ * @param temp The temperature in degrees C, batt_mv is used for the voltage
+ * @returns The length of the packet
+ */
+static uint8_t build_compact(float temp)
+{
+    uint8_t* b;
+    uint8_t flags = tx_power;
+    int16_t t;
+#ifdef STACKPAINT
+    uint16_t headroom;
+#endif
+
+    t = temp_deci(temp);
+    b = compact_pack((uint8_t*)packetbuf, HOPS[0] - '0', seqid, batt_mv, t);
+
+    if(power_mode == MODE_BOOSTOFF)
+        flags |= COMPACT_MODE;
+#ifdef FUEL_GAUGE
+    flags |= COMPACT_FUEL;
+#endif
+#ifdef STACKPAINT
+    flags |= COMPACT_STACK;
+#endif
+
+    *b++ = wake_freq;
+    *b++ = flags;
+    *b++ = nvlog.bod_resets;
+    *b++ = (uint8_t)nvlog.boots;
+    *b++ = (uint8_t)(nvlog.boots >> 8);
+
+#ifdef FUEL_GAUGE
+    {
+        uint16_t i = fuel_current();
+        *b++ = (uint8_t)i;
+        *b++ = (uint8_t)(i >> 8);
+        *b++ = fuel_spread();
+    }
+#endif
+
+#ifdef STACKPAINT
+    headroom = stack_headroom();
+    *b++ = headroom > 255 ? 255 : (uint8_t)headroom;
+#endif
+
+    /* Node ID to the end */
+    strcpy((char*)b, NODE_ID);
+    b += strlen(NODE_ID);
+
+    return b - (uint8_t*)packetbuf;
+}
+#endif
+
+#if defined(COMPACT) || defined(HISTORY)
+/**
+ * Round a temperature to 0.1degC as the text beacon does.
+ * @param temp The temperature in degrees C
+ * @returns The temperature in 0.1degC
+ */
+static int16_t temp_deci(float temp)
+{
+    return (int16_t)(temp * 10 + (temp < 0 ? -0.5 : 0.5));
+}
+#endif
+
+#ifdef HISTORY
+/**
+ * Send a history frame (see history.h) after this beacon. It isn't a
+ * beacon itself, so it doesn't take a sequence ID.
+ */
+static void send_history(void)
+{
+    uint8_t* b;
+
+    b = history_frame((uint8_t*)packetbuf, HOPS[0] - '0', seqid);
+    strcpy((char*)b, NODE_ID);
+    b += strlen(NODE_ID);
+
+    rf69_send((uint8_t*)packetbuf, b - (uint8_t*)packetbuf, tx_power);
+    _delay_ms(10);
+}
+#endif
+
+/**
+ * Move on to the next sequence ID. After the 'a' sent at startup this
+ * carries on from where the node was before it reset.
+ */
+static void next_seqid(void)
+{
+    if(seqid == 'a')
+        seqid = resume_seqid;
+    else if(seqid == 'z')
+        seqid = 'b';
+    else
+        seqid++;
+}
+
+#ifdef PROFILE
+/**
+ * Send the profiler's table as three diagnostic packets (see prof.h) and
+ * start it again. They use sequence IDs like any other packet.
+ */
+static void send_profile(void)
+{
+    static const char rows[] = { PROF_ROW_MIN, PROF_ROW_MEAN, PROF_ROW_MAX };
+    uint8_t i;
+
+    for(i = 0; i < sizeof(rows); i++)
+    {
+        p = packetbuf;
+        strcpy(p, HOPS);
+        p += strlen(p);
+        *p++ = seqid;
+        *p++ = ':';
+        *p++ = 'P';
+        p = prof_row(p, rows[i]);
+        *p++ = '[';
+        strcpy(p, NODE_ID);
+        p += strlen(p);
+        *p++ = ']';
+        *p = '\0';
+
+        rf69_send((uint8_t*)packetbuf, strlen(packetbuf), tx_power);
+        _delay_ms(10);
+
+        next_seqid();
+        nvlog_beacon(seqid, 0);
+    }
+
+    prof_reset();
+#ifdef HISTORY
+    /* The next beacon won't follow on from the last */
+    history_reset();
+#endif
+}
+#endif
+
 /**
  * Return the temperature from the onboard DS18B20 to precision 0.1degC
  * @returns the temperature in degrees C.
@@ -311,5 +686,13 @@ ISR(EXT_INT0_vect)
 /* Watchdog interrupt */
 ISR(WATCHDOG_vect)
 {
+#ifdef FUEL_GAUGE
+    // Only the fuel gauge runs the watchdog without the reset enabled
+    if(!(WDTCSR & _BV(WDE)))
+    {
+        fuel_ticks++;
+        return;
+    }
+#endif
     wdt_disable();
 }
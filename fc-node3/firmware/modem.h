@@ -0,0 +1,50 @@
+/**
+ * Modem profiles, chosen for each deployment with make MODEM=n.
+ *
+ * Every byte of preamble costs 4ms of PA current at 2kbps, and the 3 bytes
+ * UKHASnet uses are only needed by receivers that spend the start of it on
+ * AFC. Once a receiver has seen the RSSI rise (about a bit), and run AFC if
+ * it has AfcAutoOn (4 bits), its bit synchroniser needs 12 bits of clean
+ * preamble before the sync word starts. Each profile is the shortest
+ * preamble, in whole bytes, that leaves some margin over that for the
+ * gateway configuration it is meant for:
+ *
+ *   MODEM_UKHASNET   Any UKHASnet gateway, including the monitor and the
+ *                    other nodes in this repo, which have AFC on.
+ *   MODEM_NOAFC      Gateways with AFC off, whose RX bandwidth covers the
+ *                    nodes' frequency error without it.
+ *
+ * A node sending a shorter preamble than its gateway needs is simply not
+ * heard, so only use MODEM_NOAFC where every gateway in range is known to
+ * have AFC off. fc-node3/host/fc-modem-sim checks that each profile still
+ * locks on its receiver as reliably as the full preamble, and reports the
+ * air time it saves.
+ *
+ * This file is also used by the host tools, so keep it to portable C.
+ */
+
+#ifndef __MODEM_H__
+#define __MODEM_H__
+
+#define MODEM_UKHASNET  0
+#define MODEM_NOAFC     1
+
+/* Preamble bytes for each profile */
+#define MODEM_UKHASNET_PREAMBLE 3
+#define MODEM_NOAFC_PREAMBLE    2
+
+/* Sync word bytes, the same for every profile, must match RF_SYNC_SIZE in
+ * RFM69Config.h */
+#define MODEM_SYNC_LEN  2
+
+#ifndef MODEM
+#define MODEM MODEM_UKHASNET
+#endif
+
+#if MODEM == MODEM_NOAFC
+#define MODEM_PREAMBLE  MODEM_NOAFC_PREAMBLE
+#else
+#define MODEM_PREAMBLE  MODEM_UKHASNET_PREAMBLE
+#endif
+
+#endif /* __MODEM_H__ */
@@ -0,0 +1,115 @@
+/**
+ * Counters that survive a reset, kept in a ring of records in EEPROM.
+ * See nvlog.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <avr/eeprom.h>
+
+#include "nvlog.h"
+
+#if NVLOG_EVERY >= 25
+#error "NVLOG_EVERY must be less than the number of sequence IDs"
+#endif
+
+nvlog_t nvlog;
+
+static nvlog_t EEMEM ee_log[NVLOG_SLOTS];
+
+/* The slot last written */
+static uint8_t slot = NVLOG_SLOTS - 1;
+
+/* Beacons since the last write */
+static uint8_t pending;
+
+/**
+ * @param r The record
+ * @returns The check byte for the record
+ */
+static uint8_t nvlog_check(const nvlog_t* r)
+{
+    const uint8_t* p = (const uint8_t*)r;
+    uint8_t i, sum = 0x5a;
+
+    for(i = 0; i < offsetof(nvlog_t, check); i++)
+        sum += p[i];
+
+    return sum;
+}
+
+/**
+ * Write the counters to the next slot, leasing sequence IDs up to
+ * NVLOG_EVERY beyond the next one to be sent.
+ * @param next_seqid The next sequence ID to be sent, 'b' to 'z'
+ */
+static void nvlog_write(char next_seqid)
+{
+    uint8_t s = (uint8_t)next_seqid + NVLOG_EVERY;
+
+    if(s > 'z')
+        s -= 'z' - 'b' + 1;
+    nvlog.seqid = s;
+
+    nvlog.seq++;
+    nvlog.check = nvlog_check(&nvlog);
+
+    if(++slot == NVLOG_SLOTS)
+        slot = 0;
+    eeprom_update_block(&nvlog, &ee_log[slot], sizeof(nvlog));
+
+    pending = 0;
+}
+
+/**
+ * Restore the counters from EEPROM, count this boot and write them back.
+ * @param brownout True if the node was reset by the brown-out detector
+ * @returns The sequence ID to use after the 'a' sent at startup
+ */
+char nvlog_boot(bool brownout)
+{
+    nvlog_t r;
+    char resume;
+    uint8_t i;
+    bool found = false;
+
+    for(i = 0; i < NVLOG_SLOTS; i++)
+    {
+        eeprom_read_block(&r, &ee_log[i], sizeof(r));
+        if(r.check != nvlog_check(&r) || r.seqid < 'b' || r.seqid > 'z')
+            continue;
+        if(!found || (int16_t)(r.seq - nvlog.seq) > 0)
+        {
+            nvlog = r;
+            slot = i;
+            found = true;
+        }
+    }
+
+    if(!found)
+        nvlog.seqid = 'b';
+
+    resume = nvlog.seqid;
+    nvlog.boots++;
+    if(brownout)
+        nvlog.bod_resets++;
+    nvlog_write(resume);
+
+    return resume;
+}
+
+/**
+ * Count a beacon, and write the counters every NVLOG_EVERY beacons.
+ * @param next_seqid The next sequence ID to be sent, 'b' to 'z'
+ * @param wakes The number of wakes since the last beacon
+ */
+void nvlog_beacon(char next_seqid, uint8_t wakes)
+{
+    nvlog.beacons++;
+    nvlog.wakes += wakes;
+
+    if(++pending >= NVLOG_EVERY)
+        nvlog_write(next_seqid);
+}
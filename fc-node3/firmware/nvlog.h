@@ -0,0 +1,50 @@
+/**
+ * Counters that survive a reset, kept in a ring of records in EEPROM.
+ *
+ * Each write goes to the slot after the last one with an increased record
+ * number, so wear is spread over NVLOG_SLOTS slots. At boot the valid record
+ * with the highest record number is restored, so a record torn by a reset
+ * while it was being written just falls back to the one before it.
+ *
+ * Counters are only written every NVLOG_EVERY beacons, and at boot, which
+ * bounds the EEPROM energy and wear. The sequence ID is leased rather than
+ * stored: each record holds the sequence ID NVLOG_EVERY beacons ahead of
+ * the next one to be sent, so after a reset the node resumes from an ID it
+ * can't have used since that record was written. Counts of beacons and
+ * wakes made since the last write are lost on a reset.
+ */
+
+#ifndef __NVLOG_H__
+#define __NVLOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Write the counters every NVLOG_EVERY beacons, must be less than the 25
+ * sequence IDs 'b' to 'z' */
+#define NVLOG_EVERY     16
+
+/* Number of records in the EEPROM ring */
+#define NVLOG_SLOTS     8
+
+/**
+ * The counters, as stored in each EEPROM record.
+ */
+typedef struct nvlog_t {
+    uint16_t seq;           // Record number, increases with each write
+    uint16_t boots;         // Times the node has started
+    uint32_t beacons;       // Beacons sent
+    uint32_t wakes;         // INT0 wakes, or MODE_WDT 64s sleeps
+    char seqid;             // Sequence ID to resume from after a reset
+    uint8_t bod_resets;     // Brown-out resets
+    uint8_t reserved;
+    uint8_t check;          // Check byte for the EEPROM record
+} nvlog_t;
+
+/* The counters since the node was first programmed */
+extern nvlog_t nvlog;
+
+char nvlog_boot(bool brownout);
+void nvlog_beacon(char next_seqid, uint8_t wakes);
+
+#endif /* __NVLOG_H__ */
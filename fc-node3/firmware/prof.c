@@ -0,0 +1,175 @@
+/**
+ * Wake phase profiler, built with make PROFILE=1.
+ * See prof.h.
+ */
+
+#ifdef PROFILE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/io.h>
+
+#include "prof.h"
+
+/* Convert Timer1 ticks to 0.1ms */
+#define PROF_TICK_US    (64000000UL / F_CPU)
+#define PROF_UNITS(t)   ((uint32_t)(t) * PROF_TICK_US / 100)
+
+typedef struct prof_stat_t {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+} prof_stat_t;
+
+/* Statistics for each phase after PROF_BOOT, over n beacons */
+static prof_stat_t stat[PROF_PHASES - 1];
+static uint8_t n;
+
+/* Time in each phase during this beacon, and the boot time */
+static uint16_t cur[PROF_PHASES];
+
+/* Timer1 at the last mark, and whether a beacon is being timed */
+static uint16_t last;
+static bool running;
+
+/* Timer1 when the marks were suspended, and whether they are */
+static uint16_t suspended_at;
+static bool suspended;
+
+/**
+ * Start Timer1 and start timing the boot.
+ */
+void prof_init(void)
+{
+    PRR &= ~_BV(PRTIM1);
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11) | _BV(CS10);
+
+    prof_reset();
+    prof_begin();
+}
+
+/**
+ * Start timing a beacon.
+ */
+void prof_begin(void)
+{
+    TCNT1 = 0;
+    last = 0;
+    running = true;
+}
+
+/**
+ * Charge the time since the last mark to a phase.
+ * @param phase The phase that has just finished
+ */
+void prof_mark(prof_phase_t phase)
+{
+    uint16_t t;
+
+    if(!running || suspended)
+        return;
+
+    t = TCNT1;
+    cur[phase] += t - last;
+    last = t;
+}
+
+/**
+ * Ignore marks until prof_resume(), for packets sent after the beacon that
+ * shouldn't be charged to it.
+ */
+void prof_suspend(void)
+{
+    suspended_at = TCNT1;
+    suspended = true;
+}
+
+/**
+ * Charge marks again, leaving out the time since prof_suspend().
+ */
+void prof_resume(void)
+{
+    last += TCNT1 - suspended_at;
+    suspended = false;
+}
+
+/**
+ * Finish timing a beacon and add it to the table.
+ */
+void prof_end(void)
+{
+    prof_stat_t* s;
+    uint8_t i;
+
+    if(!running)
+        return;
+    prof_mark(PROF_SLEEP);
+    running = false;
+
+    for(i = PROF_BOOT + 1; i < PROF_PHASES; i++)
+    {
+        s = &stat[i - 1];
+        if(!n || cur[i] < s->min)
+            s->min = cur[i];
+        if(!n || cur[i] > s->max)
+            s->max = cur[i];
+        s->sum += cur[i];
+        cur[i] = 0;
+    }
+    n++;
+}
+
+/**
+ * @returns true if it's time to send the table
+ */
+bool prof_due(void)
+{
+    return n >= PROF_EVERY;
+}
+
+/**
+ * Write one row of the table, as a comma separated list of times.
+ * @param p Where to write it
+ * @param row PROF_ROW_MIN, PROF_ROW_MEAN or PROF_ROW_MAX
+ * @returns A pointer to the terminating null
+ */
+char* prof_row(char* p, char row)
+{
+    uint32_t t;
+    uint8_t i;
+
+    *p++ = row;
+    for(i = PROF_BOOT; i < PROF_PHASES; i++)
+    {
+        if(i == PROF_BOOT)
+            t = cur[i];
+        else if(row == PROF_ROW_MIN)
+            t = stat[i - 1].min;
+        else if(row == PROF_ROW_MAX)
+            t = stat[i - 1].max;
+        else
+            t = n ? stat[i - 1].sum / n : 0;
+
+        if(i != PROF_BOOT)
+            *p++ = ',';
+        utoa(PROF_UNITS(t), p, 10);
+        p += strlen(p);
+    }
+
+    return p;
+}
+
+/**
+ * Empty the table.
+ */
+void prof_reset(void)
+{
+    memset(stat, 0, sizeof(stat));
+    n = 0;
+}
+
+#endif /* PROFILE */
@@ -0,0 +1,71 @@
+/**
+ * Wake phase profiler, built with make PROFILE=1.
+ *
+ * Times each phase of a beacon with Timer1, clocked at F_CPU/64 so that a
+ * tick is 64us at 1MHz and the longest phase it can time is 4.2s. Each
+ * PROF_MARK() charges the time since the last mark to a phase, and the
+ * totals for each beacon are added to the min, max and mean for the phase
+ * when prof_end() is called. Boot is timed once, from reset to the main
+ * loop.
+ *
+ * Every PROF_EVERY beacons the table is sent as three diagnostic packets,
+ * one each for the min, mean and max, with a UKHASnet comment field like
+ *
+ *     :Pa<boot>,<adc>,<ds18b20>,<build>,<radio>,<pa>,<air>,<sleep>
+ *
+ * where the letter after P is n (min), a (mean) or x (max) and the times
+ * are in units of 0.1ms. The table then starts again.
+ *
+ * Packets sent after the beacon, such as history frames, are left out by
+ * wrapping them in prof_suspend() and prof_resume().
+ *
+ * The table takes about 80 bytes of RAM, so other build options may need
+ * to be turned off to make room.
+ */
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Send the table every PROF_EVERY beacons */
+#define PROF_EVERY      10
+
+/**
+ * Phases of a beacon, in the order they happen.
+ */
+typedef enum prof_phase_t {
+    PROF_BOOT = 0,      // Reset to the main loop, once
+    PROF_ADC,           // Battery voltage
+    PROF_DS18B20,       // Temperature
+    PROF_BUILD,         // Everything else up to rf69_send()
+    PROF_RADIO,         // RFM69 oscillator start up, in rf69_send()
+    PROF_PA,            // PA ramp up
+    PROF_AIR,           // Air time
+    PROF_SLEEP,         // From the end of the packet to going back to sleep
+    PROF_PHASES
+} prof_phase_t;
+
+/* The rows of the table sent */
+#define PROF_ROW_MIN    'n'
+#define PROF_ROW_MEAN   'a'
+#define PROF_ROW_MAX    'x'
+
+#ifdef PROFILE
+#define PROF_MARK(phase) prof_mark(phase)
+#else
+#define PROF_MARK(phase) do { } while(0)
+#endif
+
+void prof_init(void);
+void prof_begin(void);
+void prof_mark(prof_phase_t phase);
+void prof_suspend(void);
+void prof_resume(void);
+void prof_end(void);
+bool prof_due(void);
+char* prof_row(char* p, char row);
+void prof_reset(void);
+
+#endif /* __PROF_H__ */
@@ -0,0 +1,90 @@
+/**
+ * Energy-neutral beacon scheduler for solar charged nodes.
+ * See sched.h.
+ */
+
+#include <stdint.h>
+
+#include "sched.h"
+
+uint8_t sched_wake_freq;
+uint8_t sched_tx_power;
+
+/* The configured TX power, which the scheduler never exceeds */
+static uint8_t tx_max;
+
+/* Smoothed cell voltage in 1/4 mV */
+static uint16_t v_avg;
+
+/* Smoothed change in cell voltage in 1/256 mV per INT0 wake */
+static int16_t trend;
+
+/**
+ * Start scheduling from the configured rate and power.
+ * @param batt_mv The cell voltage now
+ * @param wake_freq The configured number of INT0 wakes per beacon
+ * @param tx_power The configured TX power in dBm
+ */
+void sched_init(uint16_t batt_mv, uint8_t wake_freq, uint8_t tx_power)
+{
+    v_avg = batt_mv << 2;
+    trend = 0;
+    sched_wake_freq = wake_freq;
+    sched_tx_power = tx_power;
+    tx_max = tx_power;
+}
+
+/**
+ * Update the schedule after a beacon.
+ * @param batt_mv The cell voltage measured for the beacon
+ * @param wakes The number of INT0 wakes since the last beacon
+ */
+void sched_update(uint16_t batt_mv, uint8_t wakes)
+{
+    int16_t dv;
+    int32_t proj;
+
+    /* Smooth out the ADC steps, which are about 3mV */
+    dv = ((int16_t)(batt_mv << 2) - (int16_t)v_avg) >> 2;
+    v_avg += dv;
+
+    /* Normalise the change by the charge drawn since the last beacon. It
+     * is limited to 64mV so that the result fits in 16 bits. */
+    if(dv > 255)
+        dv = 255;
+    else if(dv < -255)
+        dv = -255;
+    dv = (dv * 64) / (int16_t)(wakes ? wakes : 1);
+    trend += (dv - trend) >> 2;
+
+    /* Where the cell will be SCHED_HORIZON wakes from now. The trend times
+     * 256 wakes is the trend itself in mV. */
+    proj = (int32_t)(v_avg >> 2) + trend;
+    if(proj < 0)
+        proj = 0;
+    else if(proj > 0xffff)
+        proj = 0xffff;
+
+    if(proj > SCHED_V_HIGH)
+    {
+        /* Surplus: full power first, then beacon a little more often */
+        if(sched_tx_power < tx_max)
+            sched_tx_power++;
+        else if(sched_wake_freq > SCHED_WAKE_MIN)
+            sched_wake_freq--;
+    }
+    else if(proj < SCHED_V_LOW)
+    {
+        /* Deficit: back off the rate quickly, then the power */
+        if(sched_wake_freq < SCHED_WAKE_MAX)
+        {
+            sched_wake_freq += (sched_wake_freq >> 1) + 1;
+            if(sched_wake_freq > SCHED_WAKE_MAX)
+                sched_wake_freq = SCHED_WAKE_MAX;
+        }
+        else if(sched_tx_power > SCHED_TX_MIN)
+        {
+            sched_tx_power--;
+        }
+    }
+}
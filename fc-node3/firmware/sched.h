@@ -0,0 +1,51 @@
+/**
+ * Energy-neutral beacon scheduler for solar charged nodes.
+ *
+ * A panel on the SOLAR header charges the cell through D1, so the only
+ * signs of harvested energy are the cell voltage and how fast it moves. The
+ * ATtiny has no clock running in power down, but every INT0 wake tops the
+ * reservoir capacitor back up from the detector threshold and so draws a
+ * fixed quantum of charge from the cell. Dividing the change in cell
+ * voltage by the number of INT0 wakes since the last beacon therefore gives
+ * the net energy balance per unit of the node's own consumption, without
+ * needing a timebase. A positive trend means the panel is delivering more
+ * than the node uses.
+ *
+ * Each beacon the scheduler projects the cell voltage SCHED_HORIZON wakes
+ * ahead and adjusts the beacon rate (INT0 wakes per beacon) and TX power to
+ * keep the projection inside [SCHED_V_LOW, SCHED_V_HIGH]. Surplus is spent
+ * first on restoring full TX power and then on beaconing more often, one
+ * step at a time. A deficit backs the rate off multiplicatively, and only
+ * once the rate is at its floor is TX power reduced. Below the band the
+ * existing MODE_WDT threshold still protects the cell.
+ */
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdint.h>
+
+/* Target band for the cell voltage in mV, suits a single NiMH cell */
+#define SCHED_V_LOW         1250
+#define SCHED_V_HIGH        1350
+
+/* Beacon every SCHED_WAKE_MIN to SCHED_WAKE_MAX INT0 wakes */
+#define SCHED_WAKE_MIN      1
+#define SCHED_WAKE_MAX      60
+
+/* Lowest TX power the scheduler will drop to in dBm */
+#define SCHED_TX_MIN        2
+
+/* How far ahead the trend is projected, in INT0 wakes. This is fixed by
+ * the trend's units (1/256 mV per wake), so the projection is just the
+ * trend added to the voltage. */
+#define SCHED_HORIZON       256
+
+/* Current schedule */
+extern uint8_t sched_wake_freq;
+extern uint8_t sched_tx_power;
+
+void sched_init(uint16_t batt_mv, uint8_t wake_freq, uint8_t tx_power);
+void sched_update(uint16_t batt_mv, uint8_t wakes);
+
+#endif /* __SCHED_H__ */
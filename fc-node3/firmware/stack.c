@@ -0,0 +1,51 @@
+/**
+ * Stack painting, built with make STACKPAINT=1.
+ * See stack.h.
+ */
+
+#ifdef STACKPAINT
+
+#include <stdint.h>
+
+#include "stack.h"
+
+/* From the linker script */
+extern uint8_t _end;
+extern uint8_t __stack;
+
+void stack_paint(void) __attribute__((naked, used, section(".init1")));
+
+/**
+ * Paint the free RAM. Runs from .init1, before the stack pointer and the
+ * zero register are set up, so it can only be assembly.
+ */
+void stack_paint(void)
+{
+    __asm__ volatile(
+            "    ldi r30, lo8(_end)\n"
+            "    ldi r31, hi8(_end)\n"
+            "    ldi r24, %0\n"
+            "    ldi r25, hi8(__stack)\n"
+            "    rjmp 2f\n"
+            "1:  st Z+, r24\n"
+            "2:  cpi r30, lo8(__stack)\n"
+            "    cpc r31, r25\n"
+            "    brlo 1b\n"
+            "    breq 1b\n"
+            :: "M" (STACK_CANARY));
+}
+
+/**
+ * @returns The number of bytes the stack has never reached since reset
+ */
+uint16_t stack_headroom(void)
+{
+    const uint8_t* p = &_end;
+
+    while(p <= &__stack && *p == STACK_CANARY)
+        p++;
+
+    return p - &_end;
+}
+
+#endif /* STACKPAINT */
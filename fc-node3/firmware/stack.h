@@ -0,0 +1,24 @@
+/**
+ * Stack painting, built with make STACKPAINT=1.
+ *
+ * Before anything else runs, all of the RAM between the end of .bss and the
+ * top of the stack is filled with STACK_CANARY. The stack overwrites it as
+ * it grows, and RAM keeps its contents while asleep, so the painted bytes
+ * left untouched at any time are the least headroom there has been since
+ * reset. Each beacon reports it in a comment field, :S<bytes>.
+ *
+ * This measures what really happened, where make size-report works out the
+ * worst case from the code. The two should roughly agree, and if the
+ * measured headroom is ever less, the static analysis has missed something.
+ */
+
+#ifndef __STACK_H__
+#define __STACK_H__
+
+#include <stdint.h>
+
+#define STACK_CANARY    0xc5
+
+uint16_t stack_headroom(void);
+
+#endif /* __STACK_H__ */
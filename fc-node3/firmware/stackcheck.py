@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""
+Worst case RAM report for the fc-node3 image.
+
+Adds the worst case stack depth to the static data and fails if what's
+left of the RAM is less than a margin.
+
+The stack depth of each function comes from the .su files gcc writes with
+-fstack-usage, which on the AVR include the registers it pushes and its
+return address. Library functions, which have no .su entries, are measured
+from their disassembly instead, as is everything in an LTO build. The call graph comes from the rcall/call
+instructions in the disassembly, and tail calls from rjmp/jmp to the start
+of another function. The worst case is the deepest path from main plus the
+deepest interrupt handler, since handlers don't nest.
+
+Indirect calls and recursion can't be bounded this way, so they are
+reported and make the check fail.
+
+Usage: stackcheck.py [--ram bytes] [--margin bytes] main.elf file.su...
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# Return address size on parts with up to 128KB of flash
+RET_ADDR = 2
+
+FUNC_RE = re.compile(r'^([0-9a-f]+) <([^>]+)>:$')
+INSN_RE = re.compile(r'^\s*([0-9a-f]+):\s+(?:[0-9a-f]{2} )+\s*(\S+)\s*([^;]*)'
+                     r'(?:;\s*0x([0-9a-f]+)(?: <([^>+]+)(\+0x[0-9a-f]+)?>)?)?')
+
+
+def read_su(paths):
+    """Map function name to static stack bytes, from .su files."""
+    usage = {}
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                fields = line.rstrip('\n').split('\t')
+                if len(fields) < 3:
+                    continue
+                name = fields[0].rsplit(':', 1)[-1]
+                usage[name] = int(fields[1])
+                if fields[2] != 'static':
+                    usage[name] = None
+    return usage
+
+
+def read_disasm(elf):
+    """
+    Map function name to (start address, instructions), where each
+    instruction is (address, mnemonic, operands, target address, target
+    name, target offset).
+    """
+    out = subprocess.run(['avr-objdump', '-d', elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True)
+    funcs = {}
+    name = None
+    for line in out.stdout.splitlines():
+        m = FUNC_RE.match(line)
+        if m:
+            name = m.group(2)
+            funcs[name] = (int(m.group(1), 16), [])
+            continue
+        m = INSN_RE.match(line)
+        if m and name:
+            target = int(m.group(4), 16) if m.group(4) else None
+            funcs[name][1].append((int(m.group(1), 16), m.group(2),
+                                   m.group(3).strip(), target, m.group(5),
+                                   m.group(6)))
+    return funcs
+
+
+def own_usage(name, insns, su):
+    """Stack bytes used by a function itself, excluding its callees."""
+    if su.get(name) is not None:
+        return su[name]
+
+    # No .su entry: count pushes and the frame it allocates by hand
+    n = RET_ADDR
+    framed = False
+    for i, (addr, op, args, target, tname, toff) in enumerate(insns):
+        if op == 'push':
+            n += 1
+        elif op == 'rcall' and args == '.+0':
+            n += RET_ADDR
+        elif not framed and op in ('sbiw', 'subi') \
+                and args.startswith('r28'):
+            frame = frame_size(op, args, insns[i + 1:i + 2])
+            if frame > 0:
+                n += frame
+                framed = True
+    return n
+
+
+def frame_size(op, args, following):
+    """
+    Bytes a prologue's sbiw or subi/sbci takes off the frame pointer Y. The
+    epilogue gives them back with adiw, or with subi/sbci of the negative
+    size, which comes out here as a negative frame and isn't counted.
+    """
+    imm = int(args.split(',')[1].strip(), 0)
+    if op == 'sbiw':
+        return imm
+
+    # A frame too big for sbiw carries into r29 with sbci
+    if following and following[0][1] == 'sbci' \
+            and following[0][2].startswith('r29'):
+        imm |= int(following[0][2].split(',')[1].strip(), 0) << 8
+        return imm - 0x10000 if imm & 0x8000 else imm
+    return imm - 0x100 if imm & 0x80 else imm
+
+
+def edges(name, funcs):
+    """Calls and tail calls out of a function, and any indirect calls."""
+    start, insns = funcs[name]
+    calls, tails, indirect = set(), set(), False
+    for (addr, op, args, target, tname, toff) in insns:
+        if op in ('icall', 'eicall', 'ijmp', 'eijmp'):
+            indirect = True
+        if not tname or toff or tname == name:
+            continue
+        if op in ('rcall', 'call'):
+            calls.add(tname)
+        elif op in ('rjmp', 'jmp') and tname in funcs:
+            tails.add(tname)
+    return calls, tails, indirect
+
+
+class Analysis:
+    def __init__(self, funcs, su):
+        self.funcs = funcs
+        self.su = su
+        self.memo = {}
+        self.problems = []
+
+    def depth(self, name, path=()):
+        """Worst case stack bytes below a function, and the path taken."""
+        if name in self.memo:
+            return self.memo[name]
+        if name in path:
+            self.problems.append('recursion: ' + ' -> '.join(path + (name,)))
+            return 0, [name]
+        if name not in self.funcs:
+            self.problems.append('no code for ' + name)
+            return 0, [name]
+
+        calls, tails, indirect = edges(name, self.funcs)
+        if indirect:
+            self.problems.append('indirect call in ' + name)
+
+        own = own_usage(name, self.funcs[name][1], self.su)
+        best, best_path = own, [name]
+        for c in calls:
+            d, p = self.depth(c, path + (name,))
+            if own + d > best:
+                best, best_path = own + d, [name] + p
+        # A tail call reuses this function's return address
+        for t in tails:
+            d, p = self.depth(t, path + (name,))
+            if own - RET_ADDR + d > best:
+                best, best_path = own - RET_ADDR + d, [name] + p
+
+        self.memo[name] = (best, best_path)
+        return self.memo[name]
+
+
+def data_size(elf):
+    """Bytes of RAM taken by .data, .bss and .noinit."""
+    out = subprocess.run(['avr-size', '-A', elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True)
+    total = 0
+    for line in out.stdout.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in ('.data', '.bss', '.noinit'):
+            total += int(fields[1])
+    return total
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('--ram', type=int, default=256)
+    ap.add_argument('--margin', type=int, default=16)
+    ap.add_argument('elf')
+    ap.add_argument('su', nargs='*')
+    args = ap.parse_args()
+
+    su = read_su(args.su)
+    funcs = read_disasm(args.elf)
+    a = Analysis(funcs, su)
+
+    print('%-28s %6s %6s' % ('function', 'own', 'worst'))
+    for name in sorted(funcs, key=lambda n: -a.depth(n)[0]):
+        if funcs[name][1]:
+            print('%-28s %6d %6d' % (name,
+                  own_usage(name, funcs[name][1], su), a.depth(name)[0]))
+
+    main_depth, main_path = a.depth('main')
+    isr_depth, isr_path = 0, []
+    for name in funcs:
+        if name.startswith('__vector_') and name != '__vector_default':
+            d, p = a.depth(name)
+            if d > isr_depth:
+                isr_depth, isr_path = d, p
+
+    data = data_size(args.elf)
+    free = args.ram - data - main_depth - isr_depth
+
+    print()
+    print('data + bss     %4d' % data)
+    print('main stack     %4d  %s' % (main_depth, ' > '.join(main_path)))
+    print('isr stack      %4d  %s' % (isr_depth, ' > '.join(isr_path)))
+    print('free           %4d of %d (margin %d)' % (free, args.ram,
+                                                     args.margin))
+
+    for p in sorted(set(a.problems)):
+        print('warning: ' + p)
+
+    if a.problems or free < args.margin:
+        print('FAIL')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,51 @@
+/**
+ * XTEA block cipher, used as a CBC-MAC to authenticate downlink frames.
+ * See xtea.h.
+ */
+
+#include <stdint.h>
+
+#include "xtea.h"
+
+#define XTEA_DELTA  0x9E3779B9UL
+#define XTEA_ROUNDS 32
+
+/**
+ * Compute the CBC-MAC of a message, with a zero IV.
+ * @param key The 128 bit key, in program memory on the AVR
+ * @param msg The message
+ * @param blocks The length of the message in XTEA_BLOCK_LEN byte blocks
+ * @param mac Set to the XTEA_BLOCK_LEN byte MAC
+ */
+void xtea_mac(const uint32_t* key, const uint8_t* msg, uint8_t blocks,
+        uint8_t* mac)
+{
+    uint32_t v0 = 0, v1 = 0, sum;
+    uint8_t i;
+
+    while(blocks--)
+    {
+        // Chain in the next block, little endian
+        for(i = 0; i < 4; i++)
+        {
+            v0 ^= (uint32_t)msg[i] << (8 * i);
+            v1 ^= (uint32_t)msg[i + 4] << (8 * i);
+        }
+        msg += XTEA_BLOCK_LEN;
+
+        for(i = 0, sum = 0; i < XTEA_ROUNDS; i++)
+        {
+            v0 += (((v1 << 4) ^ (v1 >> 5)) + v1)
+                ^ (sum + XTEA_KEY_READ(&key[sum & 3]));
+            sum += XTEA_DELTA;
+            v1 += (((v0 << 4) ^ (v0 >> 5)) + v0)
+                ^ (sum + XTEA_KEY_READ(&key[(sum >> 11) & 3]));
+        }
+    }
+
+    for(i = 0; i < 4; i++)
+    {
+        mac[i] = v0 >> (8 * i);
+        mac[i + 4] = v1 >> (8 * i);
+    }
+}
@@ -0,0 +1,27 @@
+/**
+ * XTEA block cipher, used as a CBC-MAC to authenticate downlink frames.
+ *
+ * Small enough for the ATtiny and plain C, so that the host tools that
+ * build frames can use the same code. CBC-MAC is only secure for messages of
+ * a fixed number of blocks, which downlink frames are.
+ */
+
+#ifndef __XTEA_H__
+#define __XTEA_H__
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define XTEA_KEY_READ(k)    pgm_read_dword(k)
+#else
+#define PROGMEM
+#define XTEA_KEY_READ(k)    (*(k))
+#endif
+
+#define XTEA_BLOCK_LEN  8
+
+void xtea_mac(const uint32_t* key, const uint8_t* msg, uint8_t blocks,
+        uint8_t* mac);
+
+#endif /* __XTEA_H__ */
@@ -0,0 +1,231 @@
+/**
+ * Build an authenticated parameter update frame for an fc-node3 built with
+ * DOWNLINK (see ../firmware/downlink.h).
+ *
+ * The frame is printed in hex, for a gateway to send as the payload of an
+ * RFM69 packet as soon as it hears the node's next beacon. The counter must
+ * be higher than that of the last update the node accepted, so keep a
+ * record of it for each node.
+ *
+ * With --aes the frame is for a node built with DOWNLINK_AES, and is printed
+ * in the clear for the gateway's RFM69 to encrypt with the same key. The
+ * time the frame takes on air, and how much of that is AES padding, is
+ * printed on stderr.
+ *
+ * Usage: fc-cfg --node id --key hex --ctr n [--freq n] [--power dBm]
+ *               [--thresh mV] [--hyst mV] [--broadcast] [--aes]
+ * The key is the 32 hex digits of DOWNLINK_KEY's words, or with --aes of
+ * DOWNLINK_AES_KEY's bytes, in order. Values
+ * not given take the firmware's defaults. The frame goes to the node's
+ * radio address, or with --broadcast to every node in range, which still
+ * check the node ID.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../firmware/xtea.h"
+}
+
+namespace {
+
+/* Must match ../firmware/downlink.h */
+const size_t MAC_LEN = 4;
+const uint8_t ADDR_BASE = 0x80;
+const uint8_t BROADCAST = 0xff;
+const size_t AES_BLOCK_LEN = 16;
+const size_t AES_ID_LEN = 6;
+
+/* Bytes on air around the payload: preamble, sync, length and CRC, and the
+ * time for each at 2kbps */
+const size_t FRAME_OVERHEAD = 3 + 2 + 1 + 2;
+const double BYTE_MS = 4.0;
+
+struct Options {
+    std::string node;
+    std::string key;
+    long ctr = -1;
+    long freq = 5;
+    long power = 10;
+    long thresh = 1350;
+    long hyst = 50;
+    bool broadcast = false;
+    bool aes = false;
+};
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: fc-cfg --node id --key hex --ctr n "
+            "[--freq n] [--power dBm] [--thresh mV] [--hyst mV] "
+            "[--broadcast] [--aes]\n");
+    std::exit(2);
+}
+
+/* Check a value is in range or give up */
+long range(const char* name, long v, long lo, long hi)
+{
+    if(v < lo || v > hi)
+    {
+        std::fprintf(stderr, "fc-cfg: %s must be %ld to %ld\n", name, lo, hi);
+        std::exit(2);
+    }
+    return v;
+}
+
+/* The node's radio address, as downlink_address() works it out */
+uint8_t address(const std::string& node)
+{
+    uint8_t h = 0;
+    for(char c : node)
+        h = h * 31 + (uint8_t)c;
+    return ADDR_BASE | (h & 0x3f);
+}
+
+/* The key as 16 bytes, in order */
+bool parse_bytes(const std::string& s, uint8_t* key)
+{
+    if(s.size() != 32)
+        return false;
+
+    for(int i = 0; i < 16; i++)
+    {
+        std::string b = s.substr(2 * i, 2);
+        char* end;
+        key[i] = std::strtoul(b.c_str(), &end, 16);
+        if(*end)
+            return false;
+    }
+    return true;
+}
+
+/* The key as XTEA's four words */
+bool parse_key(const std::string& s, uint32_t* key)
+{
+    if(s.size() != 32)
+        return false;
+
+    for(int i = 0; i < 4; i++)
+    {
+        std::string w = s.substr(8 * i, 8);
+        char* end;
+        key[i] = std::strtoul(w.c_str(), &end, 16);
+        if(*end)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    uint32_t key[4];
+    uint8_t aes_key[16];
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--broadcast")
+            opt.broadcast = true;
+        else if(a == "--aes")
+            opt.aes = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--node")
+            opt.node = argv[++i];
+        else if(a == "--key")
+            opt.key = argv[++i];
+        else if(a == "--ctr")
+            opt.ctr = std::atol(argv[++i]);
+        else if(a == "--freq")
+            opt.freq = std::atol(argv[++i]);
+        else if(a == "--power")
+            opt.power = std::atol(argv[++i]);
+        else if(a == "--thresh")
+            opt.thresh = std::atol(argv[++i]);
+        else if(a == "--hyst")
+            opt.hyst = std::atol(argv[++i]);
+        else
+            usage();
+    }
+
+    if(opt.node.empty() || opt.ctr < 0
+            || !(opt.aes ? parse_bytes(opt.key, aes_key)
+                : parse_key(opt.key, key)))
+        usage();
+    range("ctr", opt.ctr, 1, 0xfffe);
+    range("freq", opt.freq, 1, 255);
+    range("power", opt.power, 2, 20);
+    range("thresh", opt.thresh, 0, 0xffff);
+    range("hyst", opt.hyst, 0, 255);
+
+    /* The cfg_t, little endian, check byte 0 */
+    uint8_t cfg[XTEA_BLOCK_LEN] = {
+        (uint8_t)opt.ctr, (uint8_t)(opt.ctr >> 8),
+        (uint8_t)opt.freq,
+        (uint8_t)opt.power,
+        (uint8_t)opt.thresh, (uint8_t)(opt.thresh >> 8),
+        (uint8_t)opt.hyst,
+        0
+    };
+
+    std::vector<uint8_t> frame;
+    frame.push_back(opt.broadcast ? BROADCAST : address(opt.node));
+    size_t xtea_len = 1 + 3 + opt.node.size() + XTEA_BLOCK_LEN + MAC_LEN;
+
+    if(opt.aes)
+    {
+        /* One block, the node ID zero padded or truncated */
+        std::string id = opt.node.substr(0, AES_ID_LEN);
+        id.resize(AES_ID_LEN, '\0');
+        frame.push_back(':');
+        frame.push_back('C');
+        frame.insert(frame.end(), cfg, cfg + XTEA_BLOCK_LEN);
+        frame.insert(frame.end(), id.begin(), id.end());
+
+        size_t data = frame.size() - 1;
+        size_t padded = (data + AES_BLOCK_LEN - 1) / AES_BLOCK_LEN
+            * AES_BLOCK_LEN;
+        size_t len = 1 + padded;
+        std::fprintf(stderr, "fc-cfg: %.0f ms on air, %.0f ms of it AES "
+                "padding, %+.0f ms against the XTEA frame\n",
+                (FRAME_OVERHEAD + len) * BYTE_MS,
+                (padded - data) * BYTE_MS,
+                ((double)len - xtea_len) * BYTE_MS);
+
+        for(uint8_t b : frame)
+            std::printf("%02x", b);
+        std::printf("\n");
+        return 0;
+    }
+
+    /* MAC over the padded node ID then the cfg_t */
+    uint8_t msg[2 * XTEA_BLOCK_LEN] = { 0 };
+    uint8_t mac[XTEA_BLOCK_LEN];
+    std::memcpy(msg, opt.node.data(),
+            std::min<size_t>(opt.node.size(), XTEA_BLOCK_LEN));
+    std::memcpy(msg + XTEA_BLOCK_LEN, cfg, XTEA_BLOCK_LEN);
+    xtea_mac(key, msg, 2, mac);
+
+    frame.push_back(':');
+    frame.push_back('C');
+    frame.insert(frame.end(), opt.node.begin(), opt.node.end());
+    frame.push_back(',');
+    frame.insert(frame.end(), cfg, cfg + XTEA_BLOCK_LEN);
+    frame.insert(frame.end(), mac, mac + MAC_LEN);
+
+    std::fprintf(stderr, "fc-cfg: %.0f ms on air\n",
+            (FRAME_OVERHEAD + frame.size()) * BYTE_MS);
+
+    for(uint8_t b : frame)
+        std::printf("%02x", b);
+    std::printf("\n");
+
+    return 0;
+}
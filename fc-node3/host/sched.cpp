@@ -0,0 +1,132 @@
+/**
+ * Host check of the beacon scheduler (see ../firmware/sched.h).
+ *
+ * Runs the firmware's own sched.c against a model cell, beacon by beacon,
+ * starting inside the target band with the configured schedule:
+ *
+ *   steady   The cell holds its voltage. The schedule must not change.
+ *   falling  The cell falls steadily. The schedule must back off while the
+ *            cell is still at least --margin mV above SCHED_V_LOW, which it
+ *            can only do from the trend.
+ *   rising   The cell rises steadily. The schedule must beacon more often
+ *            while the cell is still at least --margin mV below
+ *            SCHED_V_HIGH.
+ *   collapse The cell falls off a cliff, so that the trend is as steep as
+ *            it can be. The schedule must back off at once.
+ *
+ * Usage: fc-sched-sim [--rate mV] [--margin mV]
+ * The rate is how far the cell moves per INT0 wake in the falling and
+ * rising runs. The exit status is 1 if any run fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+extern "C" {
+#include "../firmware/sched.h"
+}
+
+namespace {
+
+/* Configured schedule, as in main.c's defaults */
+const uint8_t WAKE_FREQ = 10;
+const uint8_t TX_POWER = 10;
+
+/* Beacons run for each case */
+const int BEACONS = 2000;
+
+struct Options {
+    double rate = 0.1;
+    double margin = 10;
+};
+
+Options opt;
+
+/**
+ * Run the scheduler with the cell moving by slope mV per wake.
+ * @param v The cell voltage at the start in mV, then where it was when the
+ * schedule first changed
+ * @returns The beacon at which the schedule first changed, or -1
+ */
+int run(double& v, double slope, double step = 0)
+{
+    sched_init((uint16_t)v, WAKE_FREQ, TX_POWER);
+
+    for(int i = 0; i < BEACONS; i++)
+    {
+        uint8_t wakes = sched_wake_freq;
+        v += slope * wakes;
+        if(i == 0)
+            v += step;
+        sched_update((uint16_t)std::lround(v), wakes);
+        if(sched_wake_freq != WAKE_FREQ || sched_tx_power != TX_POWER)
+            return i;
+    }
+    return -1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: fc-sched-sim [--rate mV] [--margin mV]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool ok = true, pass;
+    double v;
+    int n;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(i + 1 >= argc)
+            usage();
+        else if(a == "--rate")
+            opt.rate = std::atof(argv[++i]);
+        else if(a == "--margin")
+            opt.margin = std::atof(argv[++i]);
+        else
+            usage();
+    }
+    if(opt.rate <= 0)
+        usage();
+
+    const double mid = (SCHED_V_LOW + SCHED_V_HIGH) / 2;
+
+    v = mid;
+    n = run(v, 0);
+    pass = n < 0;
+    ok = ok && pass;
+    std::printf("steady    schedule %s  %s\n",
+            pass ? "unchanged" : "changed", pass ? "ok" : "FAIL");
+
+    v = mid;
+    n = run(v, -opt.rate);
+    pass = n >= 0 && sched_wake_freq > WAKE_FREQ
+        && v >= SCHED_V_LOW + opt.margin;
+    ok = ok && pass;
+    std::printf("falling   backed off at %.1f mV, %.1f mV above the band  "
+            "%s\n", v, v - SCHED_V_LOW, pass ? "ok" : "FAIL");
+
+    v = mid;
+    n = run(v, opt.rate);
+    pass = n >= 0 && sched_wake_freq < WAKE_FREQ
+        && v <= SCHED_V_HIGH - opt.margin;
+    ok = ok && pass;
+    std::printf("rising    sped up at %.1f mV, %.1f mV below the band  %s\n",
+            v, SCHED_V_HIGH - v, pass ? "ok" : "FAIL");
+
+    v = mid;
+    n = run(v, 0, -(mid - 100));
+    pass = n == 0 && sched_wake_freq > WAKE_FREQ;
+    ok = ok && pass;
+    std::printf("collapse  backed off %s  %s\n",
+            n == 0 ? "at once" : "late", pass ? "ok" : "FAIL");
+
+    return ok ? 0 : 1;
+}
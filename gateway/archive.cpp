@@ -0,0 +1,326 @@
+/**
+ * Keep the voltage and temperature history of every node heard (see
+ * store.h).
+ *
+ * Reads one packet per line on stdin, as the receive time in ms and the
+ * text packet separated by a space, and adds the V field in mV and the T
+ * field in 0.1degC to the store in dir. Malformed lines are reported on
+ * stderr and skipped, and packets without either field are ignored.
+ *
+ * With --query it instead prints the time and value of each reading of one
+ * node's field, V or T, in a range of times.
+ *
+ * With --bench it fills an empty store with a synthetic fleet's history,
+ * then reports the space taken per reading, the rate readings went in and
+ * the time taken by queries, and checks every reading comes back out after
+ * the store is reopened.
+ *
+ * Usage: gw-archive dir < packets
+ *        gw-archive dir --query node field from to
+ *        gw-archive dir --bench [--nodes n] [--days n]
+ * The exit status is 1 if any line was malformed or the bench check failed.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frame.h"
+#include "store.h"
+
+using namespace ukhasnet;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string dir;
+    bool bench = false;
+    unsigned nodes = 1000;
+    unsigned days = 30;
+};
+
+Options opt;
+
+double since(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+bool open(Store& store)
+{
+    if(!store.open(opt.dir))
+    {
+        std::fprintf(stderr, "gw-archive: can't open %s: %s\n",
+                opt.dir.c_str(), std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int archive()
+{
+    Store store;
+    std::string line, text;
+    int status = 0;
+
+    if(!open(store))
+        return 1;
+
+    while(std::getline(std::cin, line))
+    {
+        std::istringstream in(line);
+        int64_t t;
+        double v;
+        Frame f;
+
+        if(line.empty())
+            continue;
+        if(!(in >> t >> text) || !parse(text, f) || f.path.empty())
+        {
+            std::fprintf(stderr, "gw-archive: malformed line %s\n",
+                    line.c_str());
+            status = 1;
+            continue;
+        }
+
+        if(field(f, 'V', 0, v))
+            store.append(f.path[0], 'V', t, std::lround(v));
+        if(field(f, 'T', 0, v))
+            store.append(f.path[0], 'T', t, std::lround(v * 10));
+    }
+
+    if(!store.flush())
+    {
+        std::fprintf(stderr, "gw-archive: can't sync %s: %s\n",
+                opt.dir.c_str(), std::strerror(errno));
+        status = 1;
+    }
+    return status;
+}
+
+int query(const std::string& node, char field, int64_t from, int64_t to)
+{
+    Store store;
+    std::vector<Point> points;
+
+    if(!open(store))
+        return 1;
+    store.query(node, field, from, to, points);
+    for(const Point& p : points)
+        std::printf("%lld %d\n", (long long)p.t, p.v);
+    return 0;
+}
+
+/* A node in the synthetic fleet, beaconing every minute or so from a cell
+ * that runs down over a month, at a temperature that rises and falls
+ * through the day */
+struct Node {
+    std::string id;
+    int64_t t;
+    double mv, drain, phase;
+};
+
+const int64_t BEACON_MS = 60000;
+const int64_t DAY_MS = 86400000;
+
+int32_t temperature(const Node& n, int64_t t, std::mt19937& rng)
+{
+    double day = 2 * M_PI * (double)t / DAY_MS + n.phase;
+    return (int32_t)std::lround(120 + 80 * std::sin(day)) + (int)(rng() % 3) - 1;
+}
+
+/* Generate the fleet's history, calling f(node, field, t, v) for each
+ * reading in time order */
+template <typename F>
+uint64_t fleet(F f)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<Node> nodes(opt.nodes);
+    uint64_t n = 0;
+
+    for(unsigned i = 0; i < opt.nodes; i++)
+    {
+        nodes[i].id = "N" + std::to_string(i);
+        nodes[i].t = (int64_t)(BEACON_MS * u(rng));
+        nodes[i].mv = 3300 + 200 * u(rng);
+        nodes[i].drain = 800.0 / (30 * 1440) * (0.5 + u(rng));
+        nodes[i].phase = 2 * M_PI * u(rng);
+    }
+
+    for(int64_t end = opt.days * DAY_MS; ; )
+    {
+        bool more = false;
+        for(unsigned i = 0; i < opt.nodes; i++)
+        {
+            Node& nd = nodes[i];
+            if(nd.t >= end)
+                continue;
+            more = true;
+
+            /* Voltage to the nearest ADC step of about 3mV */
+            nd.mv -= nd.drain;
+            f(i, 'V', nd.t, (int32_t)(std::lround(nd.mv / 3.2) * 32 / 10));
+            f(i, 'T', nd.t, temperature(nd, nd.t, rng));
+            n += 2;
+            nd.t += BEACON_MS - 500 + rng() % 1000;
+        }
+        if(!more)
+            break;
+    }
+    return n;
+}
+
+int bench()
+{
+    std::vector<std::string> ids(opt.nodes);
+    for(unsigned i = 0; i < opt.nodes; i++)
+        ids[i] = "N" + std::to_string(i);
+
+    Store store;
+    if(!open(store))
+        return 1;
+    if(store.points())
+    {
+        std::fprintf(stderr, "gw-archive: %s isn't empty\n",
+                opt.dir.c_str());
+        return 1;
+    }
+
+    Clock::time_point t0 = Clock::now();
+    uint64_t n = fleet([&](unsigned i, char field, int64_t t, int32_t v) {
+                store.append(ids[i], field, t, v);
+            });
+    store.flush();
+    double secs = since(t0);
+    std::printf("%llu readings from %u nodes over %u days, %.1fM per s\n",
+            (unsigned long long)n, opt.nodes, opt.days, n / secs / 1e6);
+    std::printf("%.1f MB, %.2f bytes per reading\n", store.bytes() / 1e6,
+            (double)store.bytes() / n);
+
+    /* Reopen, as after a restart, and check everything is there */
+    t0 = Clock::now();
+    store.close();
+    if(!open(store))
+        return 1;
+    std::printf("reopened in %.0f ms\n", 1e3 * since(t0));
+
+    std::vector<std::vector<Point>> got(2 * opt.nodes);
+    t0 = Clock::now();
+    for(unsigned i = 0; i < opt.nodes; i++)
+    {
+        store.query(ids[i], 'V', 0, INT64_MAX, got[2 * i]);
+        store.query(ids[i], 'T', 0, INT64_MAX, got[2 * i + 1]);
+    }
+    secs = since(t0);
+    std::printf("whole history of every node in %.0f ms, %.0fM readings "
+            "per s\n", 1e3 * secs, n / secs / 1e6);
+
+    std::vector<size_t> pos(2 * opt.nodes, 0);
+    uint64_t bad = 0;
+    fleet([&](unsigned i, char field, int64_t t, int32_t v) {
+                unsigned k = 2 * i + (field == 'T');
+                if(pos[k] >= got[k].size() || got[k][pos[k]].t != t
+                        || got[k][pos[k]].v != v)
+                    bad++;
+                pos[k]++;
+            });
+    for(unsigned k = 0; k < 2 * opt.nodes; k++)
+    {
+        if(got[k].size() > pos[k])
+            bad += got[k].size() - pos[k];
+    }
+
+    /* Decoding alone, with and without SSE2, on one node's voltages */
+    std::vector<int64_t> bt;
+    std::vector<int32_t> bv;
+    for(size_t j = 0; j < COLUMN_BLOCK && j < got[0].size(); j++)
+    {
+        bt.push_back(got[0][j].t);
+        bv.push_back(got[0][j].v);
+    }
+    ColumnHeader h;
+    uint8_t data[COLUMN_MAX_SIZE];
+    int64_t dt[COLUMN_BLOCK];
+    int32_t dv[COLUMN_BLOCK];
+    unsigned reps = 200000;
+    column_encode(bt.data(), bv.data(), bt.size(), h, data);
+    t0 = Clock::now();
+    for(unsigned r = 0; r < reps; r++)
+        column_decode(h, data, dt, dv);
+    double simd = since(t0);
+    t0 = Clock::now();
+    for(unsigned r = 0; r < reps; r++)
+        column_decode_scalar(h, data, dt, dv);
+    double scalar = since(t0);
+    std::printf("block decode: %.0fM readings per s, %.0fM without SSE2\n",
+            reps * h.count / simd / 1e6, reps * h.count / scalar / 1e6);
+
+    /* A day of one node at a time, as a dashboard would ask for */
+    std::mt19937 rng(2);
+    std::vector<Point> day;
+    unsigned queries = 10000;
+    t0 = Clock::now();
+    for(unsigned q = 0; q < queries; q++)
+    {
+        int64_t from = rng() % (opt.days * DAY_MS);
+        day.clear();
+        store.query(ids[rng() % opt.nodes], 'V', from, from + DAY_MS, day);
+    }
+    std::printf("one node's day: %.1f us per query\n",
+            1e6 * since(t0) / queries);
+
+    std::printf("%llu readings wrong  %s\n", (unsigned long long)bad,
+            bad ? "FAIL" : "ok");
+    return bad ? 1 : 0;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: gw-archive dir < packets\n"
+            "       gw-archive dir --query node field from to\n"
+            "       gw-archive dir --bench [--nodes n] [--days n]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+        usage();
+    opt.dir = argv[1];
+
+    if(argc == 7 && std::string(argv[2]) == "--query"
+            && std::strlen(argv[4]) == 1)
+        return query(argv[3], argv[4][0], std::atoll(argv[5]),
+                std::atoll(argv[6]));
+
+    for(int i = 2; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--bench")
+            opt.bench = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--nodes")
+            opt.nodes = std::atoi(argv[++i]);
+        else if(a == "--days")
+            opt.days = std::atoi(argv[++i]);
+        else
+            usage();
+    }
+    if(!opt.nodes || !opt.days)
+        usage();
+
+    return opt.bench ? bench() : archive();
+}
@@ -0,0 +1,265 @@
+/**
+ * Compressed blocks of one telemetry field's readings.
+ * See column.h.
+ */
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "column.h"
+
+namespace ukhasnet {
+
+namespace {
+
+const size_t LANES = 4;
+
+uint32_t zigzag(uint32_t d)
+{
+    return (d << 1) ^ (uint32_t)-(d >> 31);
+}
+
+uint32_t unzigzag(uint32_t z)
+{
+    return (z >> 1) ^ (uint32_t)-(z & 1);
+}
+
+unsigned width(const uint32_t* z)
+{
+    uint32_t all = 0;
+    unsigned b = 0;
+
+    for(size_t i = 0; i < COLUMN_BLOCK; i++)
+        all |= z[i];
+    while(all)
+    {
+        b++;
+        all >>= 1;
+    }
+    return b;
+}
+
+/**
+ * Pack COLUMN_BLOCK numbers of b bits. Number i goes in lane i % 4, and
+ * each lane's words are interleaved with the others'.
+ */
+void pack(const uint32_t* z, unsigned b, uint8_t* data)
+{
+    uint32_t words[COLUMN_BLOCK];
+
+    for(size_t lane = 0; lane < LANES; lane++)
+    {
+        uint64_t acc = 0;
+        unsigned bits = 0;
+        size_t w = 0;
+
+        for(size_t i = lane; i < COLUMN_BLOCK; i += LANES)
+        {
+            acc |= (uint64_t)z[i] << bits;
+            bits += b;
+            if(bits >= 32)
+            {
+                words[w++ * LANES + lane] = (uint32_t)acc;
+                acc >>= 32;
+                bits -= 32;
+            }
+        }
+    }
+    std::memcpy(data, words, 16 * b);
+}
+
+void unpack_scalar(const uint8_t* data, unsigned b, uint32_t* z)
+{
+    uint32_t words[COLUMN_BLOCK];
+    uint32_t mask = b == 32 ? 0xffffffff : (1u << b) - 1;
+
+    std::memcpy(words, data, 16 * b);
+    for(size_t lane = 0; lane < LANES; lane++)
+    {
+        uint64_t acc = 0;
+        unsigned bits = 0;
+        size_t w = 0;
+
+        for(size_t i = lane; i < COLUMN_BLOCK; i += LANES)
+        {
+            if(bits < b)
+            {
+                acc |= (uint64_t)words[w++ * LANES + lane] << bits;
+                bits += 32;
+            }
+            z[i] = (uint32_t)acc & mask;
+            acc >>= b;
+            bits -= b;
+        }
+    }
+}
+
+/* Running sum, undoing the zig-zag first */
+void sum_scalar(uint32_t* z, uint32_t first)
+{
+    uint32_t s = first;
+
+    for(size_t i = 0; i < COLUMN_BLOCK; i++)
+    {
+        s += unzigzag(z[i]);
+        z[i] = s;
+    }
+}
+
+#ifdef __SSE2__
+
+void unpack_sse2(const uint8_t* data, unsigned b, uint32_t* z)
+{
+    const __m128i* in = (const __m128i*)data;
+    __m128i mask, cur;
+    unsigned shift = 0;
+
+    if(!b)
+    {
+        std::memset(z, 0, COLUMN_BLOCK * sizeof(*z));
+        return;
+    }
+    mask = _mm_set1_epi32(b == 32 ? -1 : (int)((1u << b) - 1));
+    cur = _mm_loadu_si128(in);
+
+    for(size_t i = 0; i < COLUMN_BLOCK; i += LANES)
+    {
+        __m128i x = _mm_srl_epi32(cur, _mm_cvtsi32_si128(shift));
+
+        shift += b;
+        if(shift >= 32)
+        {
+            shift -= 32;
+            if(i + LANES < COLUMN_BLOCK)
+                cur = _mm_loadu_si128(++in);
+            if(shift)
+                x = _mm_or_si128(x, _mm_sll_epi32(cur,
+                            _mm_cvtsi32_si128(b - shift)));
+        }
+        _mm_storeu_si128((__m128i*)(z + i), _mm_and_si128(x, mask));
+    }
+}
+
+void sum_sse2(uint32_t* z, uint32_t first)
+{
+    __m128i one = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(first);
+
+    for(size_t i = 0; i < COLUMN_BLOCK; i += LANES)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(z + i));
+
+        x = _mm_xor_si128(_mm_srli_epi32(x, 1),
+                _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128((__m128i*)(z + i), x);
+        carry = _mm_shuffle_epi32(x, 0xff);
+    }
+}
+
+#endif
+
+/**
+ * Unpack one block. The running sum of the times' packed differences gives
+ * the intervals, which are summed again here.
+ */
+template <bool SIMD>
+void decode(const ColumnHeader& h, const uint8_t* data, int64_t* t,
+        int32_t* v)
+{
+    uint32_t dt[COLUMN_BLOCK], dv[COLUMN_BLOCK];
+    const uint8_t* vdata = data + 16 * h.tbits;
+
+#ifdef __SSE2__
+    if(SIMD)
+    {
+        unpack_sse2(data, h.tbits, dt);
+        sum_sse2(dt, h.dt1);
+        unpack_sse2(vdata, h.vbits, dv);
+        sum_sse2(dv, h.v0);
+    }
+    else
+#endif
+    {
+        unpack_scalar(data, h.tbits, dt);
+        sum_scalar(dt, h.dt1);
+        unpack_scalar(vdata, h.vbits, dv);
+        sum_scalar(dv, h.v0);
+    }
+
+    /* The block is under 2^31 ms long, so the offsets fit in 32 bits */
+    uint32_t off = 0;
+    for(size_t i = 0; i < h.count; i++)
+    {
+        if(i)
+            off += dt[i];
+        t[i] = h.t0 + off;
+        v[i] = (int32_t)dv[i];
+    }
+}
+
+} // namespace
+
+size_t column_encode(const int64_t* t, const int32_t* v, size_t n,
+        ColumnHeader& h, uint8_t* data)
+{
+    uint32_t dt[COLUMN_BLOCK] = { 0 }, dv[COLUMN_BLOCK] = { 0 };
+    uint32_t prev;
+
+    if(n > COLUMN_BLOCK)
+        n = COLUMN_BLOCK;
+    for(size_t i = 1; i < n; i++)
+    {
+        if(t[i] < t[i - 1] || t[i] - t[0] >= 0x80000000LL)
+        {
+            n = i;
+            break;
+        }
+    }
+    if(!n)
+        return 0;
+
+    h.t0 = t[0];
+    h.t_last = t[n - 1];
+    h.dt1 = n > 1 ? (int32_t)(t[1] - t[0]) : 0;
+    h.v0 = v[0];
+    h.count = (uint8_t)n;
+    h.pad = 0;
+
+    /* Interval i is from reading i - 1 to i, and interval 0 is taken to be
+     * the same as interval 1 */
+    prev = h.dt1;
+    for(size_t i = 1; i < n; i++)
+    {
+        uint32_t d = (uint32_t)(t[i] - t[i - 1]);
+        dt[i] = zigzag(d - prev);
+        prev = d;
+        dv[i] = zigzag((uint32_t)v[i] - (uint32_t)v[i - 1]);
+    }
+
+    h.tbits = width(dt);
+    h.vbits = width(dv);
+    pack(dt, h.tbits, data);
+    pack(dv, h.vbits, data + 16 * h.tbits);
+
+    return n;
+}
+
+void column_decode(const ColumnHeader& h, const uint8_t* data, int64_t* t,
+        int32_t* v)
+{
+    decode<true>(h, data, t, v);
+}
+
+void column_decode_scalar(const ColumnHeader& h, const uint8_t* data,
+        int64_t* t, int32_t* v)
+{
+    decode<false>(h, data, t, v);
+}
+
+} // namespace ukhasnet
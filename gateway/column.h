@@ -0,0 +1,63 @@
+/**
+ * Compressed blocks of one telemetry field's readings.
+ *
+ * Nodes beacon at nearly regular intervals and their voltage and
+ * temperature change slowly, so a block stores the difference between
+ * successive intervals (delta of delta) for the times and the difference
+ * between successive readings for the values. Both are small, and are
+ * zig-zag coded and bit packed at the width of the largest in the block.
+ * Each is laid out in four interleaved lanes, so that with SSE2 four
+ * readings are unpacked and summed at once.
+ *
+ * A block holds up to COLUMN_BLOCK readings of up to 2^31 ms altogether.
+ */
+
+#ifndef __COLUMN_H__
+#define __COLUMN_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ukhasnet {
+
+const size_t COLUMN_BLOCK = 128;
+
+struct ColumnHeader {
+    int64_t t0;             // First time in ms
+    int64_t t_last;         // Last time in ms
+    int32_t dt1;            // First interval
+    int32_t v0;             // First value
+    uint8_t count;
+    uint8_t tbits, vbits;   // Packed widths
+    uint8_t pad;
+};
+
+/* Bytes of packed data after a header */
+inline size_t column_size(const ColumnHeader& h)
+{
+    return 16 * (h.tbits + h.vbits);
+}
+
+/* Most bytes of packed data a block can have */
+const size_t COLUMN_MAX_SIZE = 16 * (32 + 32);
+
+/**
+ * Pack up to COLUMN_BLOCK readings, in time order, into a block of up to
+ * COLUMN_MAX_SIZE bytes.
+ * @returns The number of readings packed
+ */
+size_t column_encode(const int64_t* t, const int32_t* v, size_t n,
+        ColumnHeader& h, uint8_t* data);
+
+/* Unpack a block's readings, using SSE2 where there is any. There must be
+ * room for COLUMN_BLOCK of each. */
+void column_decode(const ColumnHeader& h, const uint8_t* data, int64_t* t,
+        int32_t* v);
+
+/* The same without SSE2, to compare against */
+void column_decode_scalar(const ColumnHeader& h, const uint8_t* data,
+        int64_t* t, int32_t* v);
+
+} // namespace ukhasnet
+
+#endif /* __COLUMN_H__ */
@@ -0,0 +1,329 @@
+/**
+ * Merging the copies of a beacon heard by more than one gateway.
+ * See dedup.h.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "dedup.h"
+
+namespace ukhasnet {
+
+namespace {
+
+/* Slots searched for a beacon from its hash's home slot on */
+const size_t PROBES = 32;
+
+} // namespace
+
+/* One received copy of a beacon, in a slot's list of copies */
+struct Dedup::Copy {
+    Frame frame;
+    int16_t rssi;
+    Copy* next;
+};
+
+/**
+ * A beacon, or a slot free for one. The key is the generation, which is
+ * now_ms / window when the first copy arrived, above the low 32 bits of the
+ * beacon's hash, or 0 if the slot has never been used. The copies are
+ * newest first, or CLOSED once they have been handed on, or CLAIMING while
+ * offer() is changing the key.
+ */
+struct Dedup::Slot {
+    std::atomic<uint64_t> key;
+    std::atomic<uint64_t> since;
+    std::atomic<Copy*> copies;
+};
+
+struct Dedup::Shard {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> counts[4];
+};
+
+Dedup::Copy* const Dedup::CLOSED = reinterpret_cast<Dedup::Copy*>(1);
+Dedup::Copy* const Dedup::CLAIMING = reinterpret_cast<Dedup::Copy*>(2);
+
+namespace {
+
+const std::string no_origin;
+
+/* The node that sent a frame's beacon */
+const std::string& origin(const Frame& f)
+{
+    return f.path.empty() ? no_origin : f.path[0];
+}
+
+/* FNV-1a of the origin and sequence ID, with the bits mixed so any of them
+ * will do to pick a shard or slot */
+uint64_t hash(const std::string& origin, char seqid)
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    for(char c : origin)
+        h = (h ^ (uint8_t)c) * 1099511628211ULL;
+    h = (h ^ (uint8_t)seqid) * 1099511628211ULL;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Generations from a key's to now's, negative if the key is from a caller
+ * whose clock is slightly ahead */
+int32_t age(uint64_t key, uint32_t gen)
+{
+    return (int32_t)(gen - (uint32_t)(key >> 32));
+}
+
+} // namespace
+
+Dedup::Dedup(uint32_t window_ms, unsigned shards, size_t slots)
+    : window(window_ms), nshards(shards), nslots(slots),
+    table(new Shard[shards])
+{
+    for(unsigned i = 0; i < nshards; i++)
+    {
+        Shard& sh = table[i];
+        sh.slots.reset(new Slot[nslots]);
+        for(size_t j = 0; j < nslots; j++)
+        {
+            sh.slots[j].key.store(0, std::memory_order_relaxed);
+            sh.slots[j].since.store(0, std::memory_order_relaxed);
+            sh.slots[j].copies.store(CLOSED, std::memory_order_relaxed);
+        }
+        for(std::atomic<uint64_t>& n : sh.counts)
+            n.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+Dedup::~Dedup()
+{
+    for(unsigned i = 0; i < nshards; i++)
+    {
+        for(size_t j = 0; j < nslots; j++)
+        {
+            Copy* c = table[i].slots[j].copies.load();
+            while(c != CLOSED && c != CLAIMING && c)
+            {
+                Copy* next = c->next;
+                delete c;
+                c = next;
+            }
+        }
+    }
+}
+
+/**
+ * Take a free slot for a new beacon.
+ * @returns false if another thread took it first
+ */
+bool Dedup::claim(Slot& s, uint64_t old_key, uint64_t key, uint64_t now_ms,
+        Copy* c)
+{
+    Copy* expect = CLOSED;
+
+    if(!s.copies.compare_exchange_strong(expect, CLAIMING,
+                std::memory_order_acq_rel))
+        return false;
+
+    /* Taken and handed on again since we looked */
+    if(s.key.load(std::memory_order_relaxed) != old_key)
+    {
+        s.copies.store(CLOSED, std::memory_order_release);
+        return false;
+    }
+
+    /* Other threads wait while CLAIMING, so the key is never seen without
+     * its copies */
+    s.since.store(now_ms, std::memory_order_relaxed);
+    s.key.store(key, std::memory_order_release);
+    c->next = nullptr;
+    s.copies.store(c, std::memory_order_release);
+    return true;
+}
+
+Dedup::Result Dedup::offer(const Frame& f, int16_t rssi, uint64_t now_ms)
+{
+    uint64_t h = hash(origin(f), f.seqid);
+    uint32_t fp = (uint32_t)h ? (uint32_t)h : 1;
+    uint32_t gen = (uint32_t)(now_ms / window);
+    uint64_t key = ((uint64_t)gen << 32) | fp;
+    Shard& sh = table[(h >> 32) & (nshards - 1)];
+    size_t home = (size_t)((h >> 32) / nshards);
+    Copy* c = new Copy{ f, rssi, nullptr };
+
+restart:
+    Slot* spare = nullptr;
+    uint64_t spare_key = 0;
+
+    for(size_t i = 0; i < PROBES; i++)
+    {
+        Slot& s = sh.slots[(home + i) & (nslots - 1)];
+        uint64_t k = s.key.load(std::memory_order_acquire);
+        Copy* head = s.copies.load(std::memory_order_acquire);
+
+        /* Look again once a claim is done, or if one came and went
+         * between loading the key and the copies */
+        if(head == CLAIMING || s.key.load(std::memory_order_acquire) != k)
+        {
+            std::this_thread::yield();
+            i--;
+            continue;
+        }
+
+        int32_t a = age(k, gen);
+        if(k && (uint32_t)k == fp && a >= -1 && a <= 1)
+        {
+            for(;;)
+            {
+                if(head == CLOSED)
+                {
+                    delete c;
+                    sh.counts[LATE].fetch_add(1, std::memory_order_relaxed);
+                    return LATE;
+                }
+                if(head == CLAIMING)
+                    goto restart;
+
+                c->next = head;
+                if(s.copies.compare_exchange_weak(head, c,
+                            std::memory_order_release,
+                            std::memory_order_acquire))
+                {
+                    sh.counts[DUPLICATE].fetch_add(1,
+                            std::memory_order_relaxed);
+                    return DUPLICATE;
+                }
+            }
+        }
+
+        if(!spare && head == CLOSED && (!k || a >= 2))
+        {
+            spare = &s;
+            spare_key = k;
+        }
+
+        /* Beacons go in the first free slot from their home slot, so none
+         * is beyond one that has never been used */
+        if(!k)
+            break;
+    }
+
+    if(!spare)
+    {
+        delete c;
+        sh.counts[FULL].fetch_add(1, std::memory_order_relaxed);
+        return FULL;
+    }
+    if(!claim(*spare, spare_key, key, now_ms, c))
+        goto restart;
+
+    sh.counts[FIRST].fetch_add(1, std::memory_order_relaxed);
+    return FIRST;
+}
+
+/**
+ * Merge a closed slot's copies, oldest last, into one frame for each beacon
+ * in it. There is only more than one if two beacons' hashes matched.
+ */
+void Dedup::merge(Copy* list, std::vector<Merged>& out)
+{
+    std::vector<Copy*> copies;
+
+    for(Copy* c = list; c; c = c->next)
+        copies.push_back(c);
+    std::reverse(copies.begin(), copies.end());
+    std::stable_sort(copies.begin(), copies.end(),
+            [](const Copy* a, const Copy* b) {
+                if(a->frame.seqid != b->frame.seqid)
+                    return a->frame.seqid < b->frame.seqid;
+                return origin(a->frame) < origin(b->frame);
+            });
+
+    for(size_t i = 0; i < copies.size(); )
+    {
+        size_t end = i + 1, best = i;
+        while(end < copies.size()
+                && copies[end]->frame.seqid == copies[i]->frame.seqid
+                && origin(copies[end]->frame) == origin(copies[i]->frame))
+            end++;
+
+        /* The earliest of the strongest */
+        for(size_t j = i + 1; j < end; j++)
+        {
+            if(copies[j]->rssi > copies[best]->rssi)
+                best = j;
+        }
+
+        Merged m;
+        m.frame = copies[best]->frame;
+        m.rssi = copies[best]->rssi;
+        m.copies = end - i;
+        for(size_t j = i; j < end; j++)
+        {
+            for(const std::string& id : copies[j]->frame.path)
+            {
+                if(std::find(m.frame.path.begin(), m.frame.path.end(), id)
+                        == m.frame.path.end())
+                    m.frame.path.push_back(id);
+            }
+        }
+        out.push_back(std::move(m));
+        i = end;
+    }
+
+    for(Copy* c : copies)
+        delete c;
+}
+
+size_t Dedup::sweep(unsigned shard, uint64_t now_ms, std::vector<Merged>& out)
+{
+    Shard& sh = table[shard];
+    size_t n = out.size();
+
+    for(size_t i = 0; i < nslots; i++)
+    {
+        Slot& s = sh.slots[i];
+        Copy* head = s.copies.load(std::memory_order_acquire);
+
+        if(head == CLOSED || head == CLAIMING
+                || now_ms < s.since.load(std::memory_order_relaxed) + window)
+            continue;
+
+        head = s.copies.exchange(CLOSED, std::memory_order_acq_rel);
+        if(head != CLOSED && head != CLAIMING)
+            merge(head, out);
+    }
+
+    return out.size() - n;
+}
+
+size_t Dedup::sweep(uint64_t now_ms, std::vector<Merged>& out)
+{
+    size_t n = 0;
+
+    for(unsigned i = 0; i < nshards; i++)
+        n += sweep(i, now_ms, out);
+    return n;
+}
+
+Dedup::Stats Dedup::stats() const
+{
+    Stats st = { 0, 0, 0, 0 };
+
+    for(unsigned i = 0; i < nshards; i++)
+    {
+        const Shard& sh = table[i];
+        st.first += sh.counts[FIRST].load(std::memory_order_relaxed);
+        st.duplicate += sh.counts[DUPLICATE].load(std::memory_order_relaxed);
+        st.late += sh.counts[LATE].load(std::memory_order_relaxed);
+        st.full += sh.counts[FULL].load(std::memory_order_relaxed);
+    }
+    return st;
+}
+
+} // namespace ukhasnet
@@ -0,0 +1,114 @@
+/**
+ * Merging the copies of a beacon heard by more than one gateway.
+ *
+ * A beacon is often heard by several gateways, both directly and through
+ * repeaters, and each copy arrives with its own hop count and path. Dedup
+ * collects the copies of each beacon, keyed on the origin node and sequence
+ * ID, for a window after the first arrives. It then hands on one frame with
+ * the data of the best copy by RSSI and every node that any copy went
+ * through in its path. Copies that arrive after the window has closed are
+ * dropped.
+ *
+ * Any number of threads may offer() frames at once. The beacons are kept in
+ * a hash set split into shards, each an open addressed table where offer()
+ * claims a slot or adds its copy to one with compare and swap, and no locks
+ * are taken. It isn't lock-free, though. A slot is marked CLAIMING while
+ * its key is changed, and a thread that probes it meanwhile yields until
+ * the claim is done. That is only a few stores, but a claiming thread that
+ * is preempted holds up the others probing that slot. Threads only contend
+ * for slots whose shard and probe sequence they share. Each copy is
+ * allocated with new, so offer() also takes the allocator's own locks, if
+ * it has any.
+ *
+ * Each shard's expired beacons are collected by sweep(), which should be
+ * called every few tens of ms and only by one thread at a time for any
+ * shard, so shards may be split between sweeper threads.
+ *
+ * Slots are reused once their beacon has been handed on and is two windows
+ * old, so the tables never need clearing. The same node and sequence ID
+ * come round again after 25 beacons, so the window must be shorter than the
+ * fastest node's beacon interval times 25, and a few seconds is plenty for
+ * the slowest repeater path. If copies of one beacon arrive at the very
+ * instant a window boundary passes, they may be handed on as two frames,
+ * which is no worse than not merging them at all.
+ */
+
+#ifndef __DEDUP_H__
+#define __DEDUP_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "frame.h"
+
+namespace ukhasnet {
+
+/* A beacon after merging */
+struct Merged {
+    Frame frame;            // Best copy, with the union of the paths
+    int16_t rssi;           // dBm of the best copy
+    unsigned copies;
+};
+
+class Dedup {
+public:
+    enum Result {
+        FIRST,              // First copy of the beacon
+        DUPLICATE,          // Merged with earlier copies
+        LATE,               // The beacon has been handed on, dropped
+        FULL,               // No room, pass the frame on unmerged
+    };
+
+    /* Counts of each result */
+    struct Stats {
+        uint64_t first, duplicate, late, full;
+    };
+
+    /**
+     * @param window_ms How long to wait for copies after the first
+     * @param shards Number of shards, a power of 2
+     * @param slots Slots in each shard, a power of 2
+     */
+    Dedup(uint32_t window_ms = 2000, unsigned shards = 64,
+            size_t slots = 16384);
+    ~Dedup();
+
+    Dedup(const Dedup&) = delete;
+    Dedup& operator=(const Dedup&) = delete;
+
+    /* Offer a received frame at now_ms on any steady clock */
+    Result offer(const Frame& f, int16_t rssi, uint64_t now_ms);
+
+    /* Hand on the beacons in one shard whose windows have closed, or in
+     * all shards. Returns the number added to out. */
+    size_t sweep(unsigned shard, uint64_t now_ms, std::vector<Merged>& out);
+    size_t sweep(uint64_t now_ms, std::vector<Merged>& out);
+
+    unsigned shards() const { return nshards; }
+    Stats stats() const;
+
+private:
+    struct Copy;
+    struct Slot;
+    struct Shard;
+
+    /* Slot states, in place of a list of copies */
+    static Copy* const CLOSED;
+    static Copy* const CLAIMING;
+
+    bool claim(Slot& s, uint64_t old_key, uint64_t key, uint64_t now_ms,
+            Copy* c);
+    void merge(Copy* list, std::vector<Merged>& out);
+
+    const uint32_t window;
+    const unsigned nshards;
+    const size_t nslots;
+    std::unique_ptr<Shard[]> table;
+};
+
+} // namespace ukhasnet
+
+#endif /* __DEDUP_H__ */
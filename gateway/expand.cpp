@@ -0,0 +1,84 @@
+/**
+ * Expand received packets into UKHASnet text (see telemetry.h).
+ *
+ * Reads one packet per line on stdin, in hex as a gateway's radio would
+ * log it, and prints each as text. A history frame is printed as the text
+ * beacons it holds, oldest first. Malformed packets are reported on stderr
+ * and skipped.
+ *
+ * Usage: gw-expand < packets
+ * The exit status is 1 if any packet was malformed.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace {
+
+bool parse_hex(const std::string& s, std::vector<uint8_t>& out)
+{
+    out.clear();
+    if(s.size() % 2)
+        return false;
+    for(size_t i = 0; i < s.size(); i += 2)
+    {
+        char* end;
+        std::string b = s.substr(i, 2);
+        out.push_back(std::strtoul(b.c_str(), &end, 16));
+        if(*end)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    std::string line, text;
+    std::vector<uint8_t> packet;
+    ukhasnet::History h;
+    int status = 0;
+
+    while(std::getline(std::cin, line))
+    {
+        if(!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        if(line.empty())
+            continue;
+
+        if(!parse_hex(line, packet))
+        {
+            std::fprintf(stderr, "gw-expand: malformed packet %s\n",
+                    line.c_str());
+            status = 1;
+            continue;
+        }
+
+        if(ukhasnet::is_history(packet.data(), packet.size()))
+        {
+            if(ukhasnet::decode_history(packet.data(), packet.size(), h))
+            {
+                for(const ukhasnet::Sample& s : h.samples)
+                    std::printf("%s\n", ukhasnet::to_text(h, s).c_str());
+                continue;
+            }
+        }
+        else if(ukhasnet::expand(packet.data(), packet.size(), text))
+        {
+            std::printf("%s\n", text.c_str());
+            continue;
+        }
+
+        std::fprintf(stderr, "gw-expand: malformed packet %s\n",
+                line.c_str());
+        status = 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,315 @@
+/**
+ * When each node's cell will run down.
+ * See forecast.h.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "forecast.h"
+
+namespace ukhasnet {
+
+namespace {
+
+/* Nodes solved at once with SSE2 */
+const size_t LANES = 2;
+
+const double MS_PER_H = 3600000.0;
+
+/* Weight pulling the temperature term towards 0, in degC^2 of readings, so
+ * the fit stays sound while a node's temperature hardly changes */
+const double RIDGE = 1.0;
+
+/* Fewest readings, and least spread of their times (h^2), to fit */
+const double MIN_READINGS = 6;
+const double MIN_VAR_H2 = 4;
+
+const double NONE = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+Forecaster::Forecaster(double wdt, double dead)
+    : wdt_mv(wdt), dead_mv(dead)
+{
+}
+
+/* Make room for another node */
+void Forecaster::grow()
+{
+    size_t n = ids.size();
+
+    mode.resize(n);
+    last_ms.resize(n);
+    for(std::vector<double>* v : { &s1, &st, &sT, &stt, &stT, &sTT, &sv,
+            &stv, &sTv, &last_mv, &a, &b, &c, &wdt_h, &dead_h })
+        v->resize(n);
+}
+
+void Forecaster::reset(size_t i)
+{
+    s1[i] = st[i] = sT[i] = stt[i] = stT[i] = sTT[i] = 0;
+    sv[i] = stv[i] = sTv[i] = 0;
+}
+
+void Forecaster::add(const std::string& node, int64_t t_ms, double mv,
+        double temp, uint8_t m)
+{
+    auto it = index.find(node);
+    size_t i;
+
+    if(it == index.end())
+    {
+        i = ids.size();
+        index[node] = i;
+        ids.push_back(node);
+        grow();
+        reset(i);
+        mode[i] = m;
+        last_ms[i] = t_ms;
+        last_mv[i] = mv;
+    }
+    else
+    {
+        i = it->second;
+        if(t_ms < last_ms[i])
+            return;
+    }
+
+    if(m != mode[i] || mv > last_mv[i] + FORECAST_NEW_CELL_MV)
+        reset(i);
+    mode[i] = m;
+
+    /* Move the time origin to this reading and age the others */
+    double dt = (t_ms - last_ms[i]) / MS_PER_H;
+    double w = std::exp(-dt / FORECAST_TAU_H);
+    stt[i] = (stt[i] - 2 * dt * st[i] + dt * dt * s1[i]) * w;
+    st[i] = (st[i] - dt * s1[i]) * w;
+    stT[i] = (stT[i] - dt * sT[i]) * w;
+    stv[i] = (stv[i] - dt * sv[i]) * w;
+    s1[i] *= w;
+    sT[i] *= w;
+    sTT[i] *= w;
+    sv[i] *= w;
+    sTv[i] *= w;
+
+    /* This reading is at t = 0 */
+    double T = temp - FORECAST_TREF;
+    s1[i] += 1;
+    sT[i] += T;
+    sTT[i] += T * T;
+    sv[i] += mv;
+    sTv[i] += T * mv;
+
+    last_ms[i] = t_ms;
+    last_mv[i] = mv;
+
+    /* Solve in pairs as readings come in */
+    if(std::find(pending.begin(), pending.end(), i) == pending.end())
+        pending.push_back(i);
+    if(pending.size() == LANES)
+        flush();
+}
+
+bool Forecaster::add(const Frame& f, int64_t t_ms)
+{
+    double mv, temp, m;
+
+    if(f.path.empty() || !field(f, 'V', 0, mv) || !field(f, 'T', 0, temp)
+            || !field(f, 'X', 2, m))
+        return false;
+
+    add(f.path[0], t_ms, mv, temp, (uint8_t)m);
+    return true;
+}
+
+/**
+ * Solve the normal equations by Cramer's rule, for nodes i and j together
+ * with SSE2 and for node k alone without. Nodes without enough readings, or
+ * without enough spread in their times, get a slope of NaN. The times to
+ * each threshold are from the bottom of the daily swing in voltage with
+ * temperature, taking the swing in temperature as a sine wave with the
+ * variance of the recent readings.
+ */
+#ifdef __SSE2__
+
+namespace {
+
+/* x ? y : z on each lane, where x is a comparison */
+inline __m128d select(__m128d x, __m128d y, __m128d z)
+{
+    return _mm_or_pd(_mm_and_pd(x, y), _mm_andnot_pd(x, z));
+}
+
+} // namespace
+
+void Forecaster::solve_block(size_t i, size_t j)
+{
+#define LOAD(v) __m128d v = _mm_set_pd(v##_[j], v##_[i])
+    const double *s1_ = s1.data(), *st_ = st.data(), *sT_ = sT.data(),
+        *stt_ = stt.data(), *stT_ = stT.data(), *sTT_ = sTT.data(),
+        *sv_ = sv.data(), *stv_ = stv.data(), *sTv_ = sTv.data();
+    LOAD(s1); LOAD(st); LOAD(sT); LOAD(stt); LOAD(stT); LOAD(sTT);
+    LOAD(sv); LOAD(stv); LOAD(sTv);
+#undef LOAD
+
+    __m128d tT = _mm_add_pd(sTT, _mm_set1_pd(RIDGE));
+    __m128d m0 = _mm_sub_pd(_mm_mul_pd(stt, tT), _mm_mul_pd(stT, stT));
+    __m128d m1 = _mm_sub_pd(_mm_mul_pd(st, tT), _mm_mul_pd(stT, sT));
+    __m128d m2 = _mm_sub_pd(_mm_mul_pd(st, stT), _mm_mul_pd(stt, sT));
+    __m128d y1 = _mm_sub_pd(_mm_mul_pd(stv, tT), _mm_mul_pd(stT, sTv));
+    __m128d y2 = _mm_sub_pd(_mm_mul_pd(stv, stT), _mm_mul_pd(stt, sTv));
+    __m128d y3 = _mm_sub_pd(_mm_mul_pd(st, sTv), _mm_mul_pd(stv, sT));
+    __m128d det = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(s1, m0),
+                _mm_mul_pd(st, m1)), _mm_mul_pd(sT, m2));
+
+    __m128d fa = _mm_div_pd(_mm_add_pd(_mm_sub_pd(_mm_mul_pd(sv, m0),
+                    _mm_mul_pd(st, y1)), _mm_mul_pd(sT, y2)), det);
+    __m128d fb = _mm_div_pd(_mm_add_pd(_mm_sub_pd(_mm_mul_pd(s1, y1),
+                    _mm_mul_pd(sv, m1)), _mm_mul_pd(sT, y3)), det);
+    __m128d fc = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(sv, m2),
+                _mm_add_pd(_mm_mul_pd(s1, y2), _mm_mul_pd(st, y3))), det);
+
+    __m128d mt = _mm_div_pd(st, s1);
+    __m128d var = _mm_sub_pd(_mm_div_pd(stt, s1), _mm_mul_pd(mt, mt));
+    __m128d ok = _mm_and_pd(_mm_cmpge_pd(s1, _mm_set1_pd(MIN_READINGS)),
+            _mm_cmpge_pd(var, _mm_set1_pd(MIN_VAR_H2)));
+    fb = select(ok, fb, _mm_set1_pd(NAN));
+
+    __m128d mT = _mm_div_pd(sT, s1);
+    __m128d swing = _mm_sqrt_pd(_mm_max_pd(_mm_setzero_pd(), _mm_mul_pd(
+                    _mm_set1_pd(2), _mm_sub_pd(_mm_div_pd(sTT, s1),
+                        _mm_mul_pd(mT, mT)))));
+    __m128d v0 = _mm_sub_pd(_mm_add_pd(fa, _mm_mul_pd(fc, mT)),
+            _mm_mul_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), fc), swing));
+    __m128d falling = _mm_cmplt_pd(fb, _mm_setzero_pd());
+    __m128d none = _mm_set1_pd(NONE);
+    __m128d wdt = _mm_set1_pd(wdt_mv), dead = _mm_set1_pd(dead_mv);
+    __m128d hw = select(falling, _mm_div_pd(_mm_sub_pd(wdt, v0), fb), none);
+    __m128d hd = select(falling, _mm_div_pd(_mm_sub_pd(dead, v0), fb), none);
+    hw = select(_mm_cmple_pd(v0, wdt), _mm_setzero_pd(), hw);
+    hd = select(_mm_cmple_pd(v0, dead), _mm_setzero_pd(), hd);
+
+#define STORE(v, x) _mm_storel_pd(&v[i], x); _mm_storeh_pd(&v[j], x)
+    STORE(a, fa);
+    STORE(b, fb);
+    STORE(c, fc);
+    STORE(wdt_h, hw);
+    STORE(dead_h, hd);
+#undef STORE
+}
+
+#endif
+
+void Forecaster::solve_one(size_t k)
+{
+    double n = s1[k];
+    double tT = sTT[k] + RIDGE;
+    double m0 = stt[k] * tT - stT[k] * stT[k];
+    double m1 = st[k] * tT - stT[k] * sT[k];
+    double m2 = st[k] * stT[k] - stt[k] * sT[k];
+    double y1 = stv[k] * tT - stT[k] * sTv[k];
+    double y2 = stv[k] * stT[k] - stt[k] * sTv[k];
+    double y3 = st[k] * sTv[k] - stv[k] * sT[k];
+    double det = n * m0 - st[k] * m1 + sT[k] * m2;
+
+    double fa = (sv[k] * m0 - st[k] * y1 + sT[k] * y2) / det;
+    double fb = (n * y1 - sv[k] * m1 + sT[k] * y3) / det;
+    double fc = (sv[k] * m2 - (n * y2 + st[k] * y3)) / det;
+
+    double mt = st[k] / n;
+    if(n < MIN_READINGS || stt[k] / n - mt * mt < MIN_VAR_H2)
+        fb = NAN;
+
+    double mT = sT[k] / n;
+    double swing = std::sqrt(std::max(0.0, 2 * (sTT[k] / n - mT * mT)));
+    double v0 = fa + fc * mT - std::fabs(fc) * swing;
+    a[k] = fa;
+    b[k] = fb;
+    c[k] = fc;
+    wdt_h[k] = v0 <= wdt_mv ? 0 : fb < 0 ? (wdt_mv - v0) / fb : NONE;
+    dead_h[k] = v0 <= dead_mv ? 0 : fb < 0 ? (dead_mv - v0) / fb : NONE;
+}
+
+void Forecaster::set_thresholds(double wdt, double dead)
+{
+    wdt_mv = wdt;
+    dead_mv = dead;
+    solve_all();
+}
+
+void Forecaster::solve_all()
+{
+    size_t k = 0;
+
+#ifdef __SSE2__
+    for(; k + LANES <= ids.size(); k += LANES)
+        solve_block(k, k + 1);
+#endif
+    for(; k < ids.size(); k++)
+        solve_one(k);
+    pending.clear();
+}
+
+void Forecaster::flush()
+{
+#ifdef __SSE2__
+    if(pending.size() == LANES)
+    {
+        solve_block(pending[0], pending[1]);
+        pending.clear();
+    }
+#endif
+    for(size_t k : pending)
+        solve_one(k);
+    pending.clear();
+}
+
+Forecast Forecaster::report(size_t i) const
+{
+    Forecast f;
+    auto when = [&](double h) {
+        return std::isfinite(h) ? last_ms[i] + (int64_t)(h * MS_PER_H)
+            : std::numeric_limits<int64_t>::max();
+    };
+
+    f.node = ids[i];
+    f.valid = !std::isnan(b[i]);
+    f.mode = mode[i];
+    f.mv = f.valid ? a[i] + c[i] * sT[i] / s1[i] : last_mv[i];
+    f.mv_per_day = f.valid ? 24 * b[i] : 0;
+    f.mv_per_degc = f.valid ? c[i] : 0;
+    f.last_ms = last_ms[i];
+    f.wdt_ms = !mode[i] ? last_ms[i] : f.valid ? when(wdt_h[i])
+        : std::numeric_limits<int64_t>::max();
+    f.dead_ms = f.valid ? when(dead_h[i])
+        : std::numeric_limits<int64_t>::max();
+    return f;
+}
+
+bool Forecaster::get(const std::string& node, Forecast& out)
+{
+    auto it = index.find(node);
+
+    if(it == index.end())
+        return false;
+    flush();
+    out = report(it->second);
+    return true;
+}
+
+void Forecaster::all(std::vector<Forecast>& out)
+{
+    flush();
+    out.clear();
+    out.reserve(ids.size());
+    for(size_t i = 0; i < ids.size(); i++)
+        out.push_back(report(i));
+}
+
+} // namespace ukhasnet
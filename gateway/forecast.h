@@ -0,0 +1,129 @@
+/**
+ * When each node's cell will run down.
+ *
+ * fc-node3 moves into MODE_WDT when its cell falls below
+ * POWER_MODE_WDT_THRESH, and from then on runs the cell down until the
+ * regulator can no longer keep going. For each node the voltage is fitted
+ * by weighted least squares as a straight line in time plus a term in the
+ * temperature, since a cell's voltage under load rises and falls with it:
+ *
+ *     V = a + b t + c (T - FORECAST_TREF)
+ *
+ * Each reading is weighted down exponentially with age, with a time
+ * constant of FORECAST_TAU_H, so the line follows the slow curve of a
+ * cell's discharge. The node acts on the first reading below a threshold,
+ * which comes at the cold end of the day if c is positive, so the forecast
+ * is where the line at the bottom of the node's recent daily swing in
+ * temperature crosses the MODE_WDT threshold and FORECAST_DEAD_MV.
+ * The fit starts again when the node changes power mode, since it then
+ * draws a different current, or the voltage jumps up because the cell has
+ * been changed. Until a node is in MODE_WDT it is drawing less than it will
+ * be at the end, so its time of death is optimistic.
+ *
+ * Each reading adds to the node's weighted sums in O(1). The sums and
+ * results for all nodes are kept as separate arrays, one value per node,
+ * and fits are solved two nodes at a time with SSE2: as readings come in,
+ * each node read is solved together with the next one, and solve_all()
+ * works through the whole fleet in pairs. A node left waiting for a
+ * partner is solved on its own by get() and all().
+ */
+
+#ifndef __FORECAST_H__
+#define __FORECAST_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "frame.h"
+
+namespace ukhasnet {
+
+/* Must match POWER_MODE_WDT_THRESH in ../fc-node3/firmware/main.c */
+const double FORECAST_WDT_MV = 1350;
+
+/* The cell voltage at which the node stops for good */
+const double FORECAST_DEAD_MV = 900;
+
+/* Time constant of the readings' weights, in hours */
+const double FORECAST_TAU_H = 168;
+
+/* Reference temperature in degC */
+const double FORECAST_TREF = 20;
+
+/* Rise in voltage that means a new cell (mV) */
+const double FORECAST_NEW_CELL_MV = 150;
+
+struct Forecast {
+    std::string node;
+    bool valid;             // Enough readings over long enough to fit
+    uint8_t mode;           // Power mode, 0 for MODE_WDT
+    double mv;              // Fitted voltage at the last reading
+    double mv_per_day;
+    double mv_per_degc;
+    int64_t last_ms;        // Time of the last reading
+    int64_t wdt_ms;         // When it reaches MODE_WDT, or INT64_MAX
+    int64_t dead_ms;        // When it dies, or INT64_MAX
+};
+
+class Forecaster {
+public:
+    Forecaster(double wdt_mv = FORECAST_WDT_MV,
+            double dead_mv = FORECAST_DEAD_MV);
+
+    /* Add a reading at t_ms of the voltage in mV, the temperature in degC
+     * and the power mode */
+    void add(const std::string& node, int64_t t_ms, double mv, double temp,
+            uint8_t mode);
+
+    /* Add the reading from a beacon. Returns false if it has no V, T or
+     * third X value. */
+    bool add(const Frame& f, int64_t t_ms);
+
+    /* Change the thresholds, and solve every node again */
+    void set_thresholds(double wdt_mv, double dead_mv);
+
+    /* Solve every node again */
+    void solve_all();
+
+    /* Solve any node still waiting for another to be solved with */
+    void flush();
+
+    /* One node's forecast. Returns false if it has never been heard. */
+    bool get(const std::string& node, Forecast& out);
+
+    /* Every node's forecast, in the order first heard */
+    void all(std::vector<Forecast>& out);
+
+    size_t size() const { return ids.size(); }
+
+private:
+    void grow();
+    void reset(size_t i);
+    void solve_block(size_t i, size_t j);
+    void solve_one(size_t k);
+    Forecast report(size_t i) const;
+
+    double wdt_mv, dead_mv;
+
+    std::unordered_map<std::string, uint32_t> index;
+    std::vector<std::string> ids;
+    std::vector<uint8_t> mode;
+    std::vector<int64_t> last_ms;
+
+    /* Weighted sums of 1, t, T, t^2, tT, T^2, V, tV and TV, with t in hours
+     * from the last reading and T from FORECAST_TREF, and the last reading,
+     * then the fit: a, b and c, and when V crosses each threshold in hours
+     * from the last reading */
+    std::vector<double> s1, st, sT, stt, stT, sTT, sv, stv, sTv, last_mv;
+    std::vector<double> a, b, c, wdt_h, dead_h;
+
+    /* Nodes read since they were last solved */
+    std::vector<size_t> pending;
+};
+
+} // namespace ukhasnet
+
+#endif /* __FORECAST_H__ */
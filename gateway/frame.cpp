@@ -0,0 +1,85 @@
+/**
+ * UKHASnet text packets.
+ * See frame.h.
+ */
+
+#include <cstdlib>
+
+#include "frame.h"
+
+namespace ukhasnet {
+
+bool parse(const std::string& text, Frame& f)
+{
+    size_t open, close;
+
+    if(text.size() < 4 || text[0] < '0' || text[0] > '9'
+            || text[1] < 'a' || text[1] > 'z')
+        return false;
+
+    open = text.find('[', 2);
+    close = text.size() - 1;
+    if(open == std::string::npos || text[close] != ']' || open + 1 == close)
+        return false;
+
+    f.hops = text[0] - '0';
+    f.seqid = text[1];
+    f.data.assign(text, 2, open - 2);
+    f.path.clear();
+
+    for(size_t p = open + 1; p <= close; )
+    {
+        size_t end = text.find_first_of(",]", p);
+        if(end == p || (text[end] == ']' && end != close))
+            return false;
+        f.path.emplace_back(text, p, end - p);
+        p = end + 1;
+    }
+
+    return true;
+}
+
+std::string to_text(const Frame& f)
+{
+    std::string text;
+
+    text += (char)('0' + f.hops);
+    text += f.seqid;
+    text += f.data;
+    text += '[';
+    for(size_t i = 0; i < f.path.size(); i++)
+    {
+        if(i)
+            text += ',';
+        text += f.path[i];
+    }
+    text += ']';
+
+    return text;
+}
+
+bool field(const Frame& f, char name, unsigned index, double& v)
+{
+    const std::string& d = f.data;
+    size_t p = d.find(name);
+
+    /* Letters only start fields, and a comment runs to the end */
+    if(p == std::string::npos || p > d.find(':'))
+        return false;
+
+    p++;
+    for(unsigned i = 0; i < index; i++)
+    {
+        p = d.find_first_not_of("0123456789.-", p);
+        if(p == std::string::npos || d[p] != ',')
+            return false;
+        p++;
+    }
+
+    const char* start = d.c_str() + p;
+    char* end;
+    v = std::strtod(start, &end);
+    return end != start;
+}
+
+} // namespace ukhasnet
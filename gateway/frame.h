@@ -0,0 +1,38 @@
+/**
+ * UKHASnet text packets, split into their parts.
+ *
+ * A packet is the hop count, the sequence ID, the data fields and the path,
+ * for example 3bV3300T21.5[NODE,REPEATER,GATEWAY]. The first node in the
+ * path is the one that sent the beacon, and each repeater or gateway that
+ * passes it on adds its own ID and takes one off the hop count.
+ */
+
+#ifndef __FRAME_H__
+#define __FRAME_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ukhasnet {
+
+struct Frame {
+    uint8_t hops;
+    char seqid;
+    std::string data;               // Between the sequence ID and the path
+    std::vector<std::string> path;  // Origin first
+};
+
+/* Split a text packet. Returns false if it is malformed. */
+bool parse(const std::string& text, Frame& f);
+
+/* Put a frame back together as text */
+std::string to_text(const Frame& f);
+
+/* Value number index of a data field, for example field(f, 'X', 2, v) for
+ * the power mode in fc-node3's X field. Returns false if there isn't one. */
+bool field(const Frame& f, char name, unsigned index, double& v);
+
+} // namespace ukhasnet
+
+#endif /* __FRAME_H__ */
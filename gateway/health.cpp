@@ -0,0 +1,209 @@
+/**
+ * Packet loss, reboots and beacon interval of every node heard.
+ * See health.h.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "health.h"
+
+namespace ukhasnet {
+
+namespace {
+
+/* Weight of each beacon in the delivery ratio, so that the last
+ * HEALTH_WINDOW carry about two thirds of it */
+const float DECAY = 1.0f - 1.0f / HEALTH_WINDOW;
+
+/* Weight of each new interval */
+const float INTERVAL_GAIN = 1.0f / 8;
+
+/* Sequence IDs in a cycle */
+const int CYCLE = 25;
+
+/* Before the interval is known, a repeat of the last sequence ID within
+ * this long is a duplicate rather than a new beacon */
+const float REPEAT_MS = 2000;
+
+uint32_t hash(const char* id, size_t len)
+{
+    uint32_t h = 2166136261u;
+
+    for(size_t i = 0; i < len; i++)
+        h = (h ^ (uint8_t)id[i]) * 16777619u;
+    return h;
+}
+
+/* Where a sequence ID from 'b' to 'z' is in the cycle */
+int position(char seqid)
+{
+    return seqid - 'b';
+}
+
+} // namespace
+
+Health::Health(size_t nodes)
+    : count(0)
+{
+    size_t n = 16;
+
+    while(n < 2 * nodes)
+        n *= 2;
+    table.assign(n, Entry());
+}
+
+const Health::Entry* Health::find(const char* id, size_t len,
+        uint32_t h) const
+{
+    size_t mask = table.size() - 1;
+
+    for(size_t i = h & mask; ; i = (i + 1) & mask)
+    {
+        const Entry& e = table[i];
+        if(!e.id[0] || (e.hash == h && !std::strncmp(e.id, id, len)
+                    && !e.id[len]))
+            return &e;
+    }
+}
+
+/* Double the table, keeping it no more than half full */
+void Health::grow()
+{
+    std::vector<Entry> old(table.size() * 2, Entry());
+    size_t mask = old.size() - 1;
+
+    old.swap(table);
+    for(const Entry& e : old)
+    {
+        if(!e.id[0])
+            continue;
+        size_t i = e.hash & mask;
+        while(table[i].id[0])
+            i = (i + 1) & mask;
+        table[i] = e;
+    }
+}
+
+bool Health::add(const std::string& node, char seqid, uint64_t now_ms)
+{
+    uint32_t h = hash(node.data(), node.size());
+    Entry* e;
+    float elapsed, d;
+    int steps;
+
+    if(node.empty() || node.size() > HEALTH_ID_LEN || seqid < 'a'
+            || seqid > 'z')
+        return false;
+
+    e = const_cast<Entry*>(find(node.data(), node.size(), h));
+    if(!e->id[0])
+    {
+        if(2 * (count + 1) > table.size())
+        {
+            grow();
+            e = const_cast<Entry*>(find(node.data(), node.size(), h));
+        }
+        std::memcpy(e->id, node.data(), node.size());
+        e->id[node.size()] = '\0';
+        e->hash = h;
+        e->seqid = seqid;
+        e->last_ms = now_ms;
+        e->frames = 1;
+        e->lost = e->reboots = 0;
+        e->rx = e->expect = 1;
+        e->interval = 0;
+        count++;
+        return true;
+    }
+
+    elapsed = now_ms > e->last_ms ? (float)(now_ms - e->last_ms) : 0;
+
+    if(seqid == 'a')
+    {
+        /* The beacons lost before a reboot can't be told, so count one */
+        if(e->seqid == 'a' && elapsed < (e->interval ? e->interval / 2
+                    : REPEAT_MS))
+            return true;
+        steps = 1;
+        e->reboots++;
+    }
+    else if(e->seqid == 'a')
+    {
+        /* After a reboot a node may carry on from anywhere in the cycle,
+         * so the next beacon starts afresh */
+        steps = 1;
+    }
+    else
+    {
+        steps = (position(seqid) - position(e->seqid) + CYCLE) % CYCLE;
+        if(e->interval)
+        {
+            long cycles = std::lround((elapsed / e->interval - steps) / CYCLE);
+            if(cycles > 0)
+                steps += CYCLE * cycles;
+        }
+        if(!steps)
+            return true;
+
+        float iv = elapsed / steps;
+        e->interval = e->interval ? e->interval
+            + (iv - e->interval) * INTERVAL_GAIN : iv;
+    }
+
+    d = std::pow(DECAY, (float)steps);
+    e->rx = e->rx * d + 1;
+    e->expect = e->expect * d + (1 - d) / (1 - DECAY);
+    e->lost += steps - 1;
+    e->frames++;
+    e->seqid = seqid;
+    e->last_ms = now_ms;
+
+    return true;
+}
+
+bool Health::add(const Frame& f, uint64_t now_ms)
+{
+    return !f.path.empty() && add(f.path[0], f.seqid, now_ms);
+}
+
+NodeHealth Health::report(const Entry& e)
+{
+    NodeHealth h;
+
+    h.node = e.id;
+    h.frames = e.frames;
+    h.lost = e.lost;
+    h.reboots = e.reboots;
+    h.delivery = e.rx / e.expect;
+    h.interval = e.interval / 1000;
+    h.last_ms = e.last_ms;
+    return h;
+}
+
+bool Health::get(const std::string& node, NodeHealth& h) const
+{
+    const Entry* e;
+
+    if(node.empty() || node.size() > HEALTH_ID_LEN)
+        return false;
+    e = find(node.data(), node.size(), hash(node.data(), node.size()));
+    if(!e->id[0])
+        return false;
+
+    h = report(*e);
+    return true;
+}
+
+void Health::all(std::vector<NodeHealth>& out) const
+{
+    out.clear();
+    out.reserve(count);
+    for(const Entry& e : table)
+    {
+        if(e.id[0])
+            out.push_back(report(e));
+    }
+}
+
+} // namespace ukhasnet
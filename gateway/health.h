@@ -0,0 +1,92 @@
+/**
+ * Packet loss, reboots and beacon interval of every node heard.
+ *
+ * A node's first beacon after boot has sequence ID 'a', and the rest run
+ * 'b' to 'z' and round again, so a gap in the sequence means beacons were
+ * lost and an 'a' means the node rebooted. After the 'a' a node may carry
+ * on from any ID, such as fc-node3 resuming from one it leased up to 16
+ * ahead, so the beacon after it is taken as a fresh start, with nothing
+ * lost and no interval. A run of 25 or more lost beacons
+ * looks like a short gap, so the time since the last beacon is used as well
+ * once the node's beacon interval is known.
+ *
+ * Each node's figures are updated in O(1) per frame in a flat open
+ * addressed table, so a gateway can keep them for thousands of nodes as
+ * frames arrive. The delivery ratio is weighted to roughly the last
+ * HEALTH_WINDOW beacons and the interval to the last 8, so a node whose
+ * antenna has come loose or that keeps browning out shows up within a few
+ * hours rather than after its lifetime's figures have caught up.
+ *
+ * Duplicates are ignored, but feed it merged frames (see dedup.h) where
+ * several gateways hear the same nodes.
+ */
+
+#ifndef __HEALTH_H__
+#define __HEALTH_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "frame.h"
+
+namespace ukhasnet {
+
+/* Beacons the averages are weighted to */
+const unsigned HEALTH_WINDOW = 32;
+
+/* Longest node ID tracked */
+const size_t HEALTH_ID_LEN = 15;
+
+struct NodeHealth {
+    std::string node;
+    uint32_t frames;        // Beacons received
+    uint32_t lost;          // Beacons missed
+    uint32_t reboots;
+    float delivery;         // Recent beacons received, 0 to 1
+    float interval;         // Recent time between beacons in s, 0 if unknown
+    uint64_t last_ms;       // When the last beacon was received
+};
+
+class Health {
+public:
+    /* Room for this many nodes before the table grows */
+    explicit Health(size_t nodes = 1024);
+
+    /* Count a beacon received at now_ms on any steady clock. Returns false
+     * if the node's ID is empty or longer than HEALTH_ID_LEN. */
+    bool add(const std::string& node, char seqid, uint64_t now_ms);
+    bool add(const Frame& f, uint64_t now_ms);
+
+    /* One node's figures. Returns false if it has never been heard. */
+    bool get(const std::string& node, NodeHealth& h) const;
+
+    /* Every node's figures, in no particular order */
+    void all(std::vector<NodeHealth>& out) const;
+
+    size_t size() const { return count; }
+
+private:
+    /* A node, or an empty slot if the ID is empty */
+    struct Entry {
+        char id[HEALTH_ID_LEN + 1];
+        uint32_t hash;
+        char seqid;             // Last received
+        uint64_t last_ms;
+        uint32_t frames, lost, reboots;
+        float rx, expect;       // Recent beacons received and expected
+        float interval;         // ms, 0 until the second beacon
+    };
+
+    const Entry* find(const char* id, size_t len, uint32_t h) const;
+    void grow();
+    static NodeHealth report(const Entry& e);
+
+    std::vector<Entry> table;
+    size_t count;
+};
+
+} // namespace ukhasnet
+
+#endif /* __HEALTH_H__ */
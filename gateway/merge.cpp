@@ -0,0 +1,256 @@
+/**
+ * Merge the copies of each beacon heard by several gateways (see dedup.h).
+ *
+ * Reads one copy per line on stdin, as the receive time in ms, the RSSI in
+ * dBm and the text packet, separated by spaces. Prints each beacon once its
+ * window has closed, as the best RSSI, the number of copies and the merged
+ * packet. Malformed lines are reported on stderr and skipped.
+ *
+ * With --bench it instead offers a synthetic fleet's traffic from 1 to
+ * --threads threads at once, with another thread sweeping, and reports the
+ * rate for each. Every beacon must come out once with all its copies.
+ *
+ * Usage: gw-merge [--window ms]
+ *        gw-merge --bench [--threads n] [--frames n] [--nodes n]
+ * The exit status is 1 if any line was malformed or the bench check failed.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dedup.h"
+
+using namespace ukhasnet;
+
+namespace {
+
+struct Options {
+    uint32_t window = 2000;
+    bool bench = false;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t frames = 1000000;
+    unsigned nodes = 100000;
+};
+
+Options opt;
+
+void print(const std::vector<Merged>& out)
+{
+    for(const Merged& m : out)
+        std::printf("%d %u %s\n", m.rssi, m.copies, to_text(m.frame).c_str());
+}
+
+int merge()
+{
+    Dedup dedup(opt.window);
+    std::vector<Merged> out;
+    std::string line, text;
+    uint64_t now = 0;
+    int status = 0;
+
+    while(std::getline(std::cin, line))
+    {
+        std::istringstream in(line);
+        uint64_t t;
+        int rssi;
+        Frame f;
+
+        if(line.empty())
+            continue;
+        if(!(in >> t >> rssi >> text) || !parse(text, f))
+        {
+            std::fprintf(stderr, "gw-merge: malformed line %s\n",
+                    line.c_str());
+            status = 1;
+            continue;
+        }
+
+        now = std::max(now, t);
+        dedup.sweep(now, out);
+        if(dedup.offer(f, rssi, t) == Dedup::FULL)
+            out.push_back(Merged{ f, (int16_t)rssi, 1 });
+        print(out);
+        out.clear();
+    }
+
+    dedup.sweep(now + opt.window, out);
+    print(out);
+
+    Dedup::Stats st = dedup.stats();
+    std::fprintf(stderr, "gw-merge: %llu beacons, %llu duplicates, "
+            "%llu late, %llu unmerged\n", (unsigned long long)st.first,
+            (unsigned long long)st.duplicate, (unsigned long long)st.late,
+            (unsigned long long)st.full);
+    return status;
+}
+
+/* A copy of a beacon as a gateway would receive it */
+struct Copy {
+    uint64_t ms;
+    int16_t rssi;
+    Frame frame;
+};
+
+/**
+ * The traffic from opt.nodes nodes beaconing in turn at 300k copies/s, each
+ * beacon heard by 1 to 4 gateways up to 500ms apart, direct or through a
+ * repeater. Returns the number of beacons.
+ */
+size_t fleet(std::vector<Copy>& copies)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> ncopies(1, 4), delay(0, 500),
+        rssi(-120, -40), gw(0, 99), repeated(0, 2);
+    std::vector<unsigned> beacons(opt.nodes, 0);
+    size_t n = 0;
+    double ms = 0;
+
+    copies.clear();
+    copies.reserve(opt.frames + 4);
+    while(copies.size() < opt.frames)
+    {
+        unsigned node = n % opt.nodes;
+        unsigned b = beacons[node]++;
+        Frame f;
+        f.seqid = b ? 'b' + (b - 1) % 25 : 'a';
+        f.data = "V3300T21.5";
+        f.path.assign(1, "N" + std::to_string(node));
+
+        for(int i = ncopies(rng); i > 0; i--)
+        {
+            Copy c{ (uint64_t)ms + delay(rng), (int16_t)rssi(rng), f };
+            c.frame.hops = 3;
+            if(!repeated(rng))
+            {
+                c.frame.hops--;
+                c.frame.path.push_back("R" + std::to_string(gw(rng)));
+            }
+            c.frame.hops--;
+            c.frame.path.push_back("G" + std::to_string(gw(rng)));
+            copies.push_back(c);
+            ms += 1000.0 / 300000;
+        }
+        n++;
+    }
+
+    std::stable_sort(copies.begin(), copies.end(),
+            [](const Copy& a, const Copy& b) { return a.ms < b.ms; });
+    return n;
+}
+
+/* Offer the copies with n threads taking turns, and check what comes out */
+bool run(const std::vector<Copy>& copies, size_t beacons, unsigned n)
+{
+    Dedup dedup(opt.window);
+    std::vector<std::atomic<uint64_t>> clock(n);
+    std::atomic<unsigned> running(n);
+    std::vector<Merged> out;
+    std::vector<std::thread> threads;
+
+    for(std::atomic<uint64_t>& t : clock)
+        t.store(0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < n; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for(size_t i = t; i < copies.size(); i += n)
+            {
+                clock[t].store(copies[i].ms, std::memory_order_relaxed);
+                dedup.offer(copies[i].frame, copies[i].rssi, copies[i].ms);
+            }
+            clock[t].store(UINT64_MAX, std::memory_order_relaxed);
+            running--;
+        });
+    }
+
+    /* Sweep up to the slowest offering thread's time, as a gateway would
+     * up to the present */
+    while(running)
+    {
+        uint64_t now = UINT64_MAX;
+        for(std::atomic<uint64_t>& t : clock)
+            now = std::min(now, t.load(std::memory_order_relaxed));
+        if(now != UINT64_MAX)
+            dedup.sweep(now, out);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for(std::thread& t : threads)
+        t.join();
+    double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+    dedup.sweep(copies.back().ms + opt.window, out);
+
+    size_t merged = 0;
+    for(const Merged& m : out)
+        merged += m.copies;
+    Dedup::Stats st = dedup.stats();
+    bool ok = out.size() == beacons && merged == copies.size() && !st.late
+        && !st.full;
+
+    std::printf("%7u %10.0f %9zu %9zu %6llu %6llu  %s\n", n,
+            copies.size() / secs, out.size(), merged,
+            (unsigned long long)st.late, (unsigned long long)st.full,
+            ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int bench()
+{
+    std::vector<Copy> copies;
+    size_t beacons = fleet(copies);
+    bool ok = true;
+
+    std::printf("%zu copies of %zu beacons from %u nodes\n", copies.size(),
+            beacons, opt.nodes);
+    std::printf("threads   copies/s   beacons    copies   late unmerged\n");
+    for(unsigned n = 1; n <= opt.threads; n *= 2)
+        ok &= run(copies, beacons, n);
+
+    return ok ? 0 : 1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: gw-merge [--window ms]\n"
+            "       gw-merge --bench [--threads n] [--frames n] "
+            "[--nodes n]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--bench")
+            opt.bench = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--window")
+            opt.window = std::atol(argv[++i]);
+        else if(a == "--threads")
+            opt.threads = std::atoi(argv[++i]);
+        else if(a == "--frames")
+            opt.frames = std::atol(argv[++i]);
+        else if(a == "--nodes")
+            opt.nodes = std::atoi(argv[++i]);
+        else
+            usage();
+    }
+    if(!opt.window || !opt.threads || !opt.frames || !opt.nodes)
+        usage();
+
+    return opt.bench ? bench() : merge();
+}
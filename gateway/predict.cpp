@@ -0,0 +1,261 @@
+/**
+ * Forecast when each node's cell will run down (see forecast.h).
+ *
+ * Reads one packet per line on stdin, as the receive time in ms and the
+ * text packet separated by a space, and at the end prints each node's
+ * voltage and its trend, and how many days from its last beacon it has
+ * until it goes into MODE_WDT and until it dies, soonest first. Malformed
+ * lines are reported on stderr and skipped, and packets without V, T and X
+ * fields are ignored.
+ *
+ * With --bench it instead runs a synthetic fleet whose cells run down at
+ * different rates and vary with temperature, checks the forecasts made
+ * part way through against when each node really reaches MODE_WDT, and
+ * reports the time taken per frame and to solve the whole fleet.
+ *
+ * Usage: gw-forecast
+ *        gw-forecast --bench [--nodes n] [--days n]
+ * The exit status is 1 if any line was malformed or the bench check failed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "forecast.h"
+
+using namespace ukhasnet;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    bool bench = false;
+    unsigned nodes = 2000;
+    unsigned days = 60;
+};
+
+Options opt;
+
+const double MS_PER_DAY = 86400000.0;
+
+/* Days from a node's last beacon to a forecast time */
+double days(const Forecast& f, int64_t t)
+{
+    return t == INT64_MAX ? INFINITY : (t - f.last_ms) / MS_PER_DAY;
+}
+
+int forecast()
+{
+    Forecaster fc;
+    std::vector<Forecast> nodes;
+    std::string line, text;
+    int status = 0;
+
+    while(std::getline(std::cin, line))
+    {
+        std::istringstream in(line);
+        int64_t t;
+        Frame f;
+
+        if(line.empty())
+            continue;
+        if(!(in >> t >> text) || !parse(text, f))
+        {
+            std::fprintf(stderr, "gw-forecast: malformed line %s\n",
+                    line.c_str());
+            status = 1;
+            continue;
+        }
+        fc.add(f, t);
+    }
+
+    fc.all(nodes);
+    std::sort(nodes.begin(), nodes.end(),
+            [](const Forecast& a, const Forecast& b) {
+                return a.dead_ms < b.dead_ms;
+            });
+
+    std::printf("%-15s %4s %6s %8s %8s %9s %9s\n", "node", "mode", "mV",
+            "mV/day", "mV/degC", "WDT days", "dead days");
+    for(const Forecast& f : nodes)
+    {
+        if(!f.valid)
+        {
+            std::printf("%-15s %4u %6.0f  (not enough readings yet)\n",
+                    f.node.c_str(), f.mode, f.mv);
+            continue;
+        }
+        std::printf("%-15s %4u %6.0f %8.1f %8.2f %9.1f %9.1f\n",
+                f.node.c_str(), f.mode, f.mv, f.mv_per_day, f.mv_per_degc,
+                days(f, f.wdt_ms), days(f, f.dead_ms));
+    }
+
+    return status;
+}
+
+/* A node in the synthetic fleet */
+struct Node {
+    std::string id;
+    double mv0;             // At 20degC, at the start
+    double drain;           // mV/h, doubled in MODE_WDT
+    double tempco;          // mV/degC
+    double phase;
+    double wdt_h;           // When it went into MODE_WDT
+    uint8_t mode;
+};
+
+const double BEACON_H = 10.0 / 60;
+
+double temperature(const Node& n, double h)
+{
+    return 12 + 8 * std::sin(2 * M_PI * h / 24 + n.phase);
+}
+
+/* The cell at 20degC, h hours from the start */
+double cell(const Node& n, double h)
+{
+    if(h < n.wdt_h)
+        return n.mv0 - n.drain * h;
+    return n.mv0 - n.drain * n.wdt_h - 2 * n.drain * (h - n.wdt_h);
+}
+
+int bench()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::normal_distribution<double> noise(0, 3);
+    std::vector<Node> fleet(opt.nodes);
+    Forecaster fc;
+
+    for(unsigned i = 0; i < opt.nodes; i++)
+    {
+        Node& n = fleet[i];
+        n.id = "N" + std::to_string(i);
+        n.mv0 = 1450 + 150 * u(rng);
+        n.drain = 0.1 + 0.4 * u(rng);
+        n.tempco = 1 + 2 * u(rng);
+        n.phase = 2 * M_PI * u(rng);
+        n.wdt_h = INFINITY;
+        n.mode = 1;
+    }
+
+    /* Forecast part way through, then run on to see what happens */
+    double check_h = 24.0 * opt.days / 3;
+    std::vector<Forecast> early(opt.nodes);
+    uint64_t frames = 0;
+    double add_secs = 0;
+
+    for(double h = 0; h < 24.0 * opt.days; h += BEACON_H)
+    {
+        Clock::time_point t0 = Clock::now();
+        for(Node& n : fleet)
+        {
+            double temp = temperature(n, h);
+            double mv = cell(n, h) + n.tempco * (temp - 20) + noise(rng);
+            if(mv < FORECAST_DEAD_MV)
+                continue;
+
+            /* As the firmware does, without the hysteresis */
+            if(n.mode && mv < FORECAST_WDT_MV)
+            {
+                n.mode = 0;
+                n.wdt_h = h;
+            }
+            fc.add(n.id, (int64_t)(h * 3600000), std::round(mv / 3.2) * 3.2,
+                    std::round(temp * 10) / 10, n.mode);
+            frames++;
+        }
+        add_secs += std::chrono::duration<double>(Clock::now() - t0).count();
+
+        if(h < check_h && h + BEACON_H >= check_h)
+        {
+            for(unsigned i = 0; i < opt.nodes; i++)
+                fc.get(fleet[i].id, early[i]);
+        }
+    }
+
+    Clock::time_point t0 = Clock::now();
+    unsigned reps = 100;
+    for(unsigned r = 0; r < reps; r++)
+        fc.solve_all();
+    double solve_secs = std::chrono::duration<double>(Clock::now()
+            - t0).count() / reps;
+
+    /* How far out the forecasts of MODE_WDT were, for the nodes that went
+     * into it after the check */
+    std::vector<double> err;
+    for(unsigned i = 0; i < opt.nodes; i++)
+    {
+        const Node& n = fleet[i];
+        const Forecast& f = early[i];
+        if(!f.valid || !std::isfinite(n.wdt_h) || n.wdt_h <= check_h)
+            continue;
+        double ahead = n.wdt_h - check_h;
+        double forecast_h = (f.wdt_ms - f.last_ms) / 3600000.0;
+        err.push_back(std::fabs(forecast_h - ahead) / ahead);
+    }
+    std::sort(err.begin(), err.end());
+
+    std::printf("%llu frames from %u nodes over %u days, %.0f ns per frame\n",
+            (unsigned long long)frames, opt.nodes, opt.days,
+            1e9 * add_secs / frames);
+    std::printf("whole fleet solved in %.0f us, %.1f ns per node\n",
+            1e6 * solve_secs, 1e9 * solve_secs / opt.nodes);
+
+    bool ok = !err.empty();
+    if(ok)
+    {
+        double median = err[err.size() / 2];
+        double p90 = err[err.size() * 9 / 10];
+        ok = median < 0.1;
+        std::printf("MODE_WDT forecast on day %.0f for %zu nodes: error %.1f%% "
+                "median, %.1f%% 90th percentile  %s\n", check_h / 24,
+                err.size(), 100 * median, 100 * p90, ok ? "ok" : "FAIL");
+    }
+    else
+    {
+        std::printf("no nodes to check  FAIL\n");
+    }
+
+    return ok ? 0 : 1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: gw-forecast\n"
+            "       gw-forecast --bench [--nodes n] [--days n]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--bench")
+            opt.bench = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--nodes")
+            opt.nodes = std::atoi(argv[++i]);
+        else if(a == "--days")
+            opt.days = std::atoi(argv[++i]);
+        else
+            usage();
+    }
+    if(!opt.nodes || !opt.days)
+        usage();
+
+    return opt.bench ? bench() : forecast();
+}
@@ -0,0 +1,295 @@
+/**
+ * Persistent queue of frames waiting to be uploaded.
+ * See queue.h.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "queue.h"
+
+namespace ukhasnet {
+
+namespace {
+
+const uint64_t MAGIC = 0x31515748534b55ULL;     // "UKHSWQ1"
+const size_t PAGE = 4096;
+
+/* A record is its length, its check value, then the frame padded to a
+ * multiple of ALIGN. A length of WRAP means the rest of the ring is unused
+ * and the next record is at the start. */
+const size_t ALIGN = 8;
+const size_t RECORD_HEADER = 8;
+const uint32_t WRAP = 0xffffffff;
+
+/* Longest frame, so that a full queue still holds a few */
+const size_t MAX_FRAME = 65536;
+
+size_t padded(size_t len)
+{
+    return (RECORD_HEADER + len + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/* msync() from the start of the system page holding p, which may be bigger
+ * than PAGE */
+bool flush(uint8_t* p, size_t len)
+{
+    static const uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)p / page * page;
+
+    return msync((void*)start, len + ((uintptr_t)p - start), MS_SYNC) == 0;
+}
+
+/* FNV-1a of the record's offset and frame */
+uint32_t check(uint64_t off, const uint8_t* data, size_t len)
+{
+    uint32_t h = 2166136261u;
+
+    for(int i = 0; i < 8; i++)
+        h = (h ^ (uint8_t)(off >> (8 * i))) * 16777619u;
+    for(size_t i = 0; i < len; i++)
+        h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+} // namespace
+
+/* The first page of the file. Offsets only ever increase, and are taken
+ * modulo the capacity to find a place in the ring. */
+struct Queue::Header {
+    uint64_t magic;
+    uint64_t capacity;
+    uint8_t pad0[48];
+    std::atomic<uint64_t> head;     // Written by push()
+    uint8_t pad1[56];
+    std::atomic<uint64_t> tail;     // Written by pop()
+};
+
+Queue::Queue()
+    : fd(-1), base(nullptr), hdr(nullptr), ring(nullptr), cap(0),
+    nrecovered(0), synced(0)
+{
+}
+
+Queue::~Queue()
+{
+    close();
+}
+
+bool Queue::open(const std::string& path, size_t capacity)
+{
+    struct stat st;
+    bool create;
+    void* p;
+
+    close();
+    if(!capacity || capacity % PAGE || capacity < 4 * MAX_FRAME)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd < 0)
+        return false;
+    if(fstat(fd, &st) < 0)
+        goto fail;
+
+    create = st.st_size == 0;
+    if(create && ftruncate(fd, PAGE + capacity) < 0)
+        goto fail;
+    if(!create && (size_t)st.st_size != PAGE + capacity)
+    {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    p = mmap(NULL, PAGE + capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+            0);
+    if(p == MAP_FAILED)
+        goto fail;
+    base = (uint8_t*)p;
+    hdr = (Header*)base;
+    ring = base + PAGE;
+    cap = capacity;
+
+    if(create)
+    {
+        hdr->capacity = cap;
+        hdr->head.store(0);
+        hdr->tail.store(0);
+        hdr->magic = MAGIC;
+        if(!flush(base, PAGE))
+            goto fail;
+    }
+    else if(hdr->magic != MAGIC || hdr->capacity != cap)
+    {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    /* Keep the frames from the tail on that check, up to the head */
+    {
+        uint64_t off = hdr->tail.load(), head = hdr->head.load();
+        nrecovered = 0;
+
+        while(off < head)
+        {
+            const uint8_t* r = at(off);
+            uint32_t len, chk;
+            std::memcpy(&len, r, 4);
+            std::memcpy(&chk, r + 4, 4);
+
+            if(len == WRAP && chk == check(off, nullptr, 0))
+            {
+                off += cap - off % cap;
+                continue;
+            }
+            if(len > MAX_FRAME || off % cap + padded(len) > cap
+                    || chk != check(off, r + RECORD_HEADER, len))
+                break;
+            off += padded(len);
+            nrecovered++;
+        }
+        hdr->head.store(off);
+        synced = off;
+    }
+
+    return true;
+
+fail:
+    int e = errno;
+    close();
+    errno = e;
+    return false;
+}
+
+void Queue::close()
+{
+    if(base)
+    {
+        sync();
+        munmap(base, PAGE + cap);
+    }
+    if(fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    base = ring = nullptr;
+    hdr = nullptr;
+    cap = 0;
+}
+
+bool Queue::push(const void* data, size_t len)
+{
+    uint64_t head = hdr->head.load(std::memory_order_relaxed);
+    uint64_t tail = hdr->tail.load(std::memory_order_acquire);
+    size_t size = padded(len);
+    size_t wrap = 0;
+
+    if(len > MAX_FRAME)
+        return false;
+    if(head % cap + size > cap)
+        wrap = cap - head % cap;
+    if(head + wrap + size - tail > cap)
+        return false;
+
+    if(wrap)
+    {
+        uint32_t chk = check(head, nullptr, 0);
+        std::memcpy(at(head), &WRAP, 4);
+        std::memcpy(at(head) + 4, &chk, 4);
+        head += wrap;
+    }
+
+    uint8_t* r = at(head);
+    uint32_t len32 = len, chk = check(head, (const uint8_t*)data, len);
+    std::memcpy(r + RECORD_HEADER, data, len);
+    std::memcpy(r, &len32, 4);
+    std::memcpy(r + 4, &chk, 4);
+
+    hdr->head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+bool Queue::peek(Batch& b, size_t max_frames, size_t max_bytes) const
+{
+    uint64_t off = hdr->tail.load(std::memory_order_relaxed);
+    uint64_t head = hdr->head.load(std::memory_order_acquire);
+    size_t bytes = 0;
+
+    b.frames.clear();
+    while(off < head && b.frames.size() < max_frames)
+    {
+        const uint8_t* r = at(off);
+        uint32_t len;
+        std::memcpy(&len, r, 4);
+
+        if(len == WRAP)
+        {
+            off += cap - off % cap;
+            continue;
+        }
+        if(!b.frames.empty() && bytes + len > max_bytes)
+            break;
+
+        b.frames.emplace_back((const char*)r + RECORD_HEADER, len);
+        bytes += len;
+        off += padded(len);
+    }
+
+    b.end = off;
+    return !b.frames.empty();
+}
+
+void Queue::pop(const Batch& b)
+{
+    hdr->tail.store(b.end, std::memory_order_release);
+}
+
+bool Queue::sync()
+{
+    uint64_t head = hdr->head.load(std::memory_order_acquire);
+    uint64_t from = synced / PAGE * PAGE;
+
+    /* The records since the last sync, in one or two pieces, then the
+     * cursors. The kernel may also write pages back by itself, in any
+     * order, which is what the records' check values are for. */
+    if(head > from)
+    {
+        uint64_t start = from % cap, end = head % cap ? head % cap : cap;
+
+        if(head - from >= cap)
+        {
+            if(!flush(ring, cap))
+                return false;
+        }
+        else if(start < end)
+        {
+            if(!flush(ring + start, end - start))
+                return false;
+        }
+        else if(!flush(ring + start, cap - start) || !flush(ring, end))
+        {
+            return false;
+        }
+    }
+    if(!flush(base, PAGE))
+        return false;
+
+    synced = head;
+    return true;
+}
+
+uint64_t Queue::used() const
+{
+    return hdr->head.load(std::memory_order_relaxed)
+        - hdr->tail.load(std::memory_order_relaxed);
+}
+
+} // namespace ukhasnet
@@ -0,0 +1,100 @@
+/**
+ * Persistent queue of frames waiting to be uploaded.
+ *
+ * When a gateway's backhaul is down it must hold on to what it receives, and
+ * not lose it if the gateway is killed or loses power meanwhile. The queue
+ * is a ring of records in a file mapped into memory, with the producer's
+ * head and the consumer's tail in the file's first page. push() copies a
+ * frame into the ring and moves the head, and pop() moves the tail once a
+ * batch has been uploaded, with no system calls on either path. The pages
+ * are in the page cache as soon as they are written, so the queue survives
+ * the process being killed. sync() writes them to disk, for surviving a
+ * power cut too, and should be called every second or so rather than for
+ * each frame.
+ *
+ * Each record carries a check value that includes its place in the ring, so
+ * on open() the queue is read from the tail up to the head or the first
+ * record that doesn't check, whichever comes first. Frames are delivered at
+ * least once: a batch uploaded but not yet popped when the gateway stops is
+ * uploaded again.
+ *
+ * One thread may push() while another peek()s and pop()s, and a third may
+ * sync().
+ */
+
+#ifndef __QUEUE_H__
+#define __QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ukhasnet {
+
+/* Frames to upload, and where they end in the ring */
+struct Batch {
+    std::vector<std::string> frames;
+    uint64_t end;
+};
+
+class Queue {
+public:
+    Queue();
+    ~Queue();
+
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
+    /* Open a queue file, or create it with a ring of capacity bytes, a
+     * multiple of 4096. Returns false on an error, with errno set. */
+    bool open(const std::string& path, size_t capacity);
+
+    void close();
+
+    /* Add a frame. Returns false if there isn't room. */
+    bool push(const void* data, size_t len);
+    bool push(const std::string& frame)
+    {
+        return push(frame.data(), frame.size());
+    }
+
+    /* Read up to max_frames frames or max_bytes bytes from the tail on,
+     * though always at least one if there are any. Returns false if the
+     * queue is empty. */
+    bool peek(Batch& b, size_t max_frames, size_t max_bytes) const;
+
+    /* Remove a batch from peek() once it has been uploaded */
+    void pop(const Batch& b);
+
+    /* Write everything pushed and popped so far to disk. Returns false on
+     * an error, with errno set. */
+    bool sync();
+
+    /* Bytes of the ring in use, and its size */
+    uint64_t used() const;
+    uint64_t capacity() const { return cap; }
+
+    /* Frames recovered by open() */
+    uint64_t recovered() const { return nrecovered; }
+
+private:
+    struct Header;
+
+    uint8_t* at(uint64_t off) const { return ring + off % cap; }
+
+    int fd;
+    uint8_t* base;
+    Header* hdr;
+    uint8_t* ring;
+    uint64_t cap;
+    uint64_t nrecovered;
+
+    /* Where the last sync() got to */
+    uint64_t synced;
+};
+
+} // namespace ukhasnet
+
+#endif /* __QUEUE_H__ */
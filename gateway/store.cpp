@@ -0,0 +1,364 @@
+/**
+ * Store for a fleet's telemetry history.
+ * See store.h.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "store.h"
+
+namespace ukhasnet {
+
+namespace {
+
+const uint32_t MAGIC = 0x53544b55;      // "UKTS"
+
+/* A block in a segment, followed by its packed data */
+struct Record {
+    uint32_t magic;
+    uint32_t check;         // FNV-1a of the rest of the record and the data
+    char node[STORE_ID_LEN + 1];
+    char field;
+    uint8_t pad[7];
+    ColumnHeader col;
+};
+
+uint32_t fnv(uint32_t h, const void* p, size_t len)
+{
+    const uint8_t* b = (const uint8_t*)p;
+
+    for(size_t i = 0; i < len; i++)
+        h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+
+uint32_t check(const Record& r, const uint8_t* data)
+{
+    const size_t skip = offsetof(Record, node);
+    uint32_t h = fnv(2166136261u, (const uint8_t*)&r + skip,
+            sizeof(Record) - skip);
+    return fnv(h, data, column_size(r.col));
+}
+
+std::string key(const std::string& node, char field)
+{
+    std::string k(node);
+    k += '\0';
+    k += field;
+    return k;
+}
+
+} // namespace
+
+struct Store::Block {
+    int64_t t0, t_last;
+    const Record* rec;
+};
+
+struct Store::Series {
+    std::string node;
+    char field;
+    std::vector<Block> blocks;
+
+    /* Readings not yet in a block */
+    int64_t t[COLUMN_BLOCK];
+    int32_t v[COLUMN_BLOCK];
+    size_t n;
+
+    int64_t last;
+};
+
+struct Store::Segment {
+    std::string path;
+    int fd;
+    uint8_t* base;
+    size_t used;
+    size_t synced;
+};
+
+Store::Store()
+    : npoints(0)
+{
+}
+
+Store::~Store()
+{
+    close();
+}
+
+Store::Series& Store::find(const std::string& node, char field)
+{
+    std::unique_ptr<Series>& s = index[key(node, field)];
+
+    if(!s)
+    {
+        s.reset(new Series());
+        s->node = node;
+        s->field = field;
+        s->n = 0;
+        s->last = INT64_MIN;
+    }
+    return *s;
+}
+
+/* Map a segment file, creating it if need be */
+bool Store::map(Segment& seg, bool create)
+{
+    struct stat st;
+    void* p;
+
+    seg.fd = ::open(seg.path.c_str(), O_RDWR | (create ? O_CREAT | O_EXCL : 0),
+            0644);
+    if(seg.fd < 0)
+        return false;
+
+    if(fstat(seg.fd, &st) < 0 || ((size_t)st.st_size < STORE_SEGMENT_SIZE
+                && ftruncate(seg.fd, STORE_SEGMENT_SIZE) < 0))
+        goto fail;
+
+    p = mmap(NULL, STORE_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+            seg.fd, 0);
+    if(p == MAP_FAILED)
+        goto fail;
+
+    seg.base = (uint8_t*)p;
+    seg.used = seg.synced = 0;
+    return true;
+
+fail:
+    int e = errno;
+    ::close(seg.fd);
+    errno = e;
+    return false;
+}
+
+/* Index a segment's blocks, up to the first that doesn't check */
+void Store::load(Segment& seg)
+{
+    size_t p = 0;
+
+    while(p + sizeof(Record) <= STORE_SEGMENT_SIZE)
+    {
+        const Record* r = (const Record*)(seg.base + p);
+        size_t size = sizeof(Record) + column_size(r->col);
+
+        if(r->magic != MAGIC || r->col.tbits > 32 || r->col.vbits > 32
+                || !r->col.count || r->col.count > COLUMN_BLOCK
+                || p + size > STORE_SEGMENT_SIZE
+                || r->node[STORE_ID_LEN] || !r->node[0]
+                || r->check != check(*r, (const uint8_t*)(r + 1)))
+            break;
+
+        Series& s = find(r->node, r->field);
+        s.blocks.push_back(Block{ r->col.t0, r->col.t_last, r });
+        s.last = r->col.t_last;
+        npoints += r->col.count;
+        p += size;
+    }
+
+    seg.used = seg.synced = p;
+}
+
+bool Store::next_segment()
+{
+    char name[32];
+    std::unique_ptr<Segment> seg(new Segment());
+
+    std::snprintf(name, sizeof(name), "/seg-%06u.dat",
+            (unsigned)segments.size());
+    seg->path = dir + name;
+    if(!map(*seg, true))
+        return false;
+
+    segments.push_back(std::move(seg));
+    return true;
+}
+
+bool Store::open(const std::string& d)
+{
+    close();
+    dir = d;
+
+    for(;;)
+    {
+        char name[32];
+        std::unique_ptr<Segment> seg(new Segment());
+
+        std::snprintf(name, sizeof(name), "/seg-%06u.dat",
+                (unsigned)segments.size());
+        seg->path = dir + name;
+        if(!map(*seg, false))
+        {
+            if(errno != ENOENT)
+                return false;
+            break;
+        }
+        load(*seg);
+        segments.push_back(std::move(seg));
+    }
+
+    return !segments.empty() || next_segment();
+}
+
+void Store::close()
+{
+    if(!segments.empty())
+        flush();
+
+    for(std::unique_ptr<Segment>& seg : segments)
+    {
+        munmap(seg->base, STORE_SEGMENT_SIZE);
+        ::close(seg->fd);
+    }
+    segments.clear();
+    index.clear();
+    npoints = 0;
+}
+
+/**
+ * Append the first block's worth of a series' readings to the segments.
+ * That is all of them unless they span more time than a block can hold.
+ */
+bool Store::write(Series& s)
+{
+    uint8_t data[COLUMN_MAX_SIZE];
+    Record r;
+    size_t n, size;
+    Segment* seg = segments.back().get();
+
+    std::memset(&r, 0, sizeof(r));
+    n = column_encode(s.t, s.v, s.n, r.col, data);
+    size = sizeof(Record) + column_size(r.col);
+
+    if(seg->used + size > STORE_SEGMENT_SIZE)
+    {
+        if(!next_segment())
+            return false;
+        seg = segments.back().get();
+    }
+
+    r.magic = MAGIC;
+    std::memcpy(r.node, s.node.data(), s.node.size());
+    r.field = s.field;
+    r.check = check(r, data);
+
+    uint8_t* p = seg->base + seg->used;
+    std::memcpy(p + sizeof(Record), data, size - sizeof(Record));
+    std::memcpy(p, &r, sizeof(Record));
+    seg->used += size;
+    s.blocks.push_back(Block{ r.col.t0, r.col.t_last, (const Record*)p });
+
+    s.n -= n;
+    std::memmove(s.t, s.t + n, s.n * sizeof(*s.t));
+    std::memmove(s.v, s.v + n, s.n * sizeof(*s.v));
+    return true;
+}
+
+bool Store::append(const std::string& node, char field, int64_t t, int32_t v)
+{
+    if(segments.empty() || node.empty() || node.size() > STORE_ID_LEN)
+        return false;
+
+    Series& s = find(node, field);
+    if(t < s.last)
+        return false;
+    if(s.n == COLUMN_BLOCK && !write(s))
+        return false;
+
+    s.t[s.n] = t;
+    s.v[s.n] = v;
+    s.n++;
+    s.last = t;
+    npoints++;
+    return true;
+}
+
+bool Store::flush()
+{
+    bool ok = true;
+
+    for(auto& i : index)
+    {
+        while(i.second->n)
+        {
+            if(!write(*i.second))
+                return false;
+        }
+    }
+
+    /* From the page the last sync ended in */
+    long page = sysconf(_SC_PAGESIZE);
+    for(std::unique_ptr<Segment>& seg : segments)
+    {
+        size_t from = seg->synced / page * page;
+        if(seg->used == seg->synced)
+            continue;
+        if(msync(seg->base + from, seg->used - from, MS_SYNC) < 0)
+            ok = false;
+        else
+            seg->synced = seg->used;
+    }
+
+    return ok;
+}
+
+size_t Store::query(const std::string& node, char field, int64_t from,
+        int64_t to, std::vector<Point>& out) const
+{
+    int64_t t[COLUMN_BLOCK];
+    int32_t v[COLUMN_BLOCK];
+    size_t n = out.size();
+
+    auto i = index.find(key(node, field));
+    if(i == index.end())
+        return 0;
+    const Series& s = *i->second;
+
+    auto b = std::lower_bound(s.blocks.begin(), s.blocks.end(), from,
+            [](const Block& blk, int64_t t) { return blk.t_last < t; });
+    for(; b != s.blocks.end() && b->t0 <= to; ++b)
+    {
+        const Record* r = b->rec;
+        column_decode(r->col, (const uint8_t*)(r + 1), t, v);
+
+        /* Most blocks are wholly in range */
+        if(b->t0 >= from && b->t_last <= to)
+        {
+            for(size_t j = 0; j < r->col.count; j++)
+                out.push_back(Point{ t[j], v[j] });
+            continue;
+        }
+        for(size_t j = 0; j < r->col.count; j++)
+        {
+            if(t[j] >= from && t[j] <= to)
+                out.push_back(Point{ t[j], v[j] });
+        }
+    }
+
+    for(size_t j = 0; j < s.n; j++)
+    {
+        if(s.t[j] >= from && s.t[j] <= to)
+            out.push_back(Point{ s.t[j], s.v[j] });
+    }
+
+    return out.size() - n;
+}
+
+uint64_t Store::bytes() const
+{
+    uint64_t n = 0;
+
+    for(const std::unique_ptr<Segment>& seg : segments)
+        n += seg->used;
+    return n;
+}
+
+} // namespace ukhasnet
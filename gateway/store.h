@@ -0,0 +1,99 @@
+/**
+ * Store for a fleet's telemetry history.
+ *
+ * Each node's fields, like V and T, are kept as separate columns of
+ * readings in compressed blocks (see column.h). Readings are held in memory
+ * until a series has a full block, which is then appended to the current
+ * segment, a file of STORE_SEGMENT_SIZE bytes mapped into memory. Writing
+ * a block is a memory copy, with no system call. The page cache keeps the
+ * segments in RAM, so a query only decodes the blocks covering its time
+ * range, found by binary search in each series' list of blocks.
+ *
+ * Each block carries its series and a check value, and on open() the
+ * segments are read back up to the first block that doesn't check, so a
+ * crash loses at most the blocks being written. Readings not yet in a block
+ * are lost too, unless flush() has written them out in a short block,
+ * which compresses less well. So flush() before closing, and perhaps every
+ * few hours, rather than after every reading.
+ */
+
+#ifndef __STORE_H__
+#define __STORE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "column.h"
+
+namespace ukhasnet {
+
+/* Longest node ID stored */
+const size_t STORE_ID_LEN = 15;
+
+const size_t STORE_SEGMENT_SIZE = 64 << 20;
+
+struct Point {
+    int64_t t;              // ms
+    int32_t v;
+};
+
+class Store {
+public:
+    Store();
+    ~Store();
+
+    Store(const Store&) = delete;
+    Store& operator=(const Store&) = delete;
+
+    /* Open or create a store in a directory, which must exist. Returns
+     * false on an error, with errno set. */
+    bool open(const std::string& dir);
+
+    /* Write out partly filled blocks and unmap the segments */
+    void close();
+
+    /* Add a reading. Readings for a series must be in time order. Returns
+     * false if it isn't, or the node's ID is empty or too long. */
+    bool append(const std::string& node, char field, int64_t t, int32_t v);
+
+    /* Write out partly filled blocks and sync the segments to disk.
+     * Returns false on an error. */
+    bool flush();
+
+    /* Add the readings of a series from from to to, inclusive, to out.
+     * Returns the number added. */
+    size_t query(const std::string& node, char field, int64_t from,
+            int64_t to, std::vector<Point>& out) const;
+
+    /* Readings stored, including those not in a block yet */
+    uint64_t points() const { return npoints; }
+
+    /* Bytes of segments used */
+    uint64_t bytes() const;
+
+    size_t series() const { return index.size(); }
+
+private:
+    struct Block;
+    struct Series;
+    struct Segment;
+
+    Series& find(const std::string& node, char field);
+    bool write(Series& s);
+    void load(Segment& seg);
+    bool map(Segment& seg, bool create);
+    bool next_segment();
+
+    std::string dir;
+    std::vector<std::unique_ptr<Segment>> segments;
+    std::unordered_map<std::string, std::unique_ptr<Series>> index;
+    uint64_t npoints;
+};
+
+} // namespace ukhasnet
+
+#endif /* __STORE_H__ */
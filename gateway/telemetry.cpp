@@ -0,0 +1,229 @@
+/**
+ * Gateway side handling of node telemetry.
+ * See telemetry.h.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "telemetry.h"
+
+extern "C" {
+#include "../fc-node3/firmware/compact.h"
+#include "../fc-node3/firmware/history.h"
+}
+
+namespace ukhasnet {
+
+namespace {
+
+/* Append an unsigned number */
+void put(std::string& s, unsigned v)
+{
+    s += std::to_string(v);
+}
+
+/* Append a temperature in 0.1degC as the node's dtostrf() would */
+void put_temp(std::string& s, int temp)
+{
+    if(temp < 0)
+        s += '-';
+    put(s, std::abs(temp) / 10);
+    s += '.';
+    put(s, std::abs(temp) % 10);
+}
+
+/* Node IDs are printable ASCII, without the path's brackets and commas */
+bool valid_id(const uint8_t* p, size_t len)
+{
+    if(!len)
+        return false;
+    for(size_t i = 0; i < len; i++)
+    {
+        if(p[i] < '!' || p[i] > '~' || p[i] == '[' || p[i] == ']'
+                || p[i] == ',')
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Expand a compact beacon into the text beacon fc-node3 would have sent
+ * (see build_beacon() in ../fc-node3/firmware/main.c).
+ */
+bool expand_compact(const uint8_t* data, size_t len, std::string& text)
+{
+    const uint8_t* end = data + len;
+    const uint8_t* p;
+    uint8_t hops, flags;
+    char seqid;
+    uint16_t mv;
+    int16_t temp;
+
+    if(len < COMPACT_LEN)
+        return false;
+
+    p = compact_unpack(data, &hops, &seqid, &mv, &temp);
+    if(hops > 9 || seqid > 'z')
+        return false;
+
+    text.clear();
+    text += (char)('0' + hops);
+    text += seqid;
+    text += 'V';
+    put(text, mv);
+    text += 'T';
+    put_temp(text, temp);
+
+    text += 'X';
+    put(text, p[0]);
+    flags = p[1];
+    text += ',';
+    put(text, flags & COMPACT_POWER_MASK);
+    text += ',';
+    put(text, (flags & COMPACT_MODE) ? 1 : 0);
+    text += ',';
+    put(text, p[2]);
+    text += ',';
+    put(text, p[3] | (p[4] << 8));
+    p += 5;
+
+    if(flags & COMPACT_FUEL)
+    {
+        if(end - p < 3)
+            return false;
+        text += ',';
+        put(text, p[0] | (p[1] << 8));
+        text += ',';
+        put(text, p[2]);
+        p += 3;
+    }
+
+    if(flags & COMPACT_STACK)
+    {
+        if(end - p < 1)
+            return false;
+        text += ":S";
+        put(text, p[0]);
+        p++;
+    }
+
+    if(!valid_id(p, end - p))
+        return false;
+    text += '[';
+    text.append((const char*)p, end - p);
+    text += ']';
+
+    return true;
+}
+
+/**
+ * Read a zig-zag varint difference.
+ * @returns false if it runs past the end or doesn't fit in 16 bits
+ */
+bool get_delta(const uint8_t*& p, const uint8_t* end, uint16_t& d)
+{
+    uint32_t z = 0;
+
+    for(int shift = 0; ; shift += 7)
+    {
+        if(p == end || shift > 14)
+            return false;
+        z |= (uint32_t)(*p & 0x7f) << shift;
+        if(!(*p++ & 0x80))
+            break;
+    }
+    if(z > 0xffff)
+        return false;
+
+    d = (uint16_t)((z >> 1) ^ -(z & 1));
+    return true;
+}
+
+/* The sequence ID before another, as fc-node3 runs them */
+char prev_seqid(char s)
+{
+    return s == 'b' ? 'z' : s - 1;
+}
+
+} // namespace
+
+bool is_compact(const uint8_t* data, size_t len)
+{
+    return len && data[0] == COMPACT_FLAG;
+}
+
+bool expand(const uint8_t* data, size_t len, std::string& text)
+{
+    if(is_compact(data, len))
+        return expand_compact(data, len, text);
+
+    /* Text packets start with the hop count */
+    if(!len || data[0] < '0' || data[0] > '9')
+        return false;
+    text.assign((const char*)data, len);
+    return true;
+}
+
+bool is_history(const uint8_t* data, size_t len)
+{
+    return len && data[0] == HISTORY_FLAG;
+}
+
+bool decode_history(const uint8_t* data, size_t len, History& h)
+{
+    const uint8_t* end = data + len;
+    const uint8_t* p = data + HISTORY_HEADER_LEN;
+    uint8_t n;
+    Sample s;
+
+    if(len < HISTORY_HEADER_LEN || !is_history(data, len))
+        return false;
+
+    h.hops = data[1];
+    s.seqid = data[2];
+    n = data[3];
+    s.mv = data[4] | (data[5] << 8);
+    s.temp = (int16_t)(data[6] | (data[7] << 8));
+    if(h.hops > 9 || s.seqid < 'b' || s.seqid > 'z' || !n)
+        return false;
+
+    h.samples.assign(1, s);
+    for(uint8_t i = 1; i < n; i++)
+    {
+        uint16_t dmv, dtemp;
+        if(!get_delta(p, end, dmv) || !get_delta(p, end, dtemp))
+            return false;
+        s.seqid = prev_seqid(s.seqid);
+        s.mv = (uint16_t)(s.mv + dmv);
+        s.temp = (int16_t)(uint16_t)(s.temp + dtemp);
+        h.samples.push_back(s);
+    }
+    std::reverse(h.samples.begin(), h.samples.end());
+
+    if(!valid_id(p, end - p))
+        return false;
+    h.node.assign((const char*)p, end - p);
+
+    return true;
+}
+
+std::string to_text(const History& h, const Sample& s)
+{
+    std::string text;
+
+    text += (char)('0' + h.hops);
+    text += s.seqid;
+    text += 'V';
+    put(text, s.mv);
+    text += 'T';
+    put_temp(text, s.temp);
+    text += '[';
+    text += h.node;
+    text += ']';
+
+    return text;
+}
+
+} // namespace ukhasnet
@@ -0,0 +1,57 @@
+/**
+ * Gateway side handling of node telemetry that isn't plain UKHASnet text.
+ *
+ * Nodes built to save air time may send their beacons in a binary form
+ * (see ../fc-node3/firmware/compact.h). The rest of the network only
+ * understands text, so a gateway expands them back into the text beacon
+ * the node would otherwise have sent, before uploading or logging them.
+ *
+ * Nodes may also send the readings from their last few beacons in a
+ * history frame (see ../fc-node3/firmware/history.h), from which a gateway
+ * can recover beacons it missed.
+ */
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ukhasnet {
+
+/* Whether a received packet is a compact beacon */
+bool is_compact(const uint8_t* data, size_t len);
+
+/* Turn a received packet into UKHASnet text. Text packets are copied as
+ * they are. Returns false if the packet is malformed. */
+bool expand(const uint8_t* data, size_t len, std::string& text);
+
+/* One beacon's readings from a history frame */
+struct Sample {
+    char seqid;
+    uint16_t mv;
+    int16_t temp;       // 0.1degC
+};
+
+/* A decoded history frame */
+struct History {
+    uint8_t hops;
+    std::string node;
+    std::vector<Sample> samples;    // Oldest first
+};
+
+/* Whether a received packet is a history frame */
+bool is_history(const uint8_t* data, size_t len);
+
+/* Decode a history frame. Returns false if it is malformed. */
+bool decode_history(const uint8_t* data, size_t len, History& h);
+
+/* The text beacon for one sample of a history frame, with the voltage and
+ * temperature only */
+std::string to_text(const History& h, const Sample& s);
+
+} // namespace ukhasnet
+
+#endif /* __TELEMETRY_H__ */
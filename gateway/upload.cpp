@@ -0,0 +1,688 @@
+/**
+ * Upload received frames through a persistent queue (see queue.h).
+ *
+ * Reads one packet per line on stdin and pushes each onto the queue in
+ * file, while another thread uploads them in batches, one frame per line,
+ * as HTTP POSTs to host:port, and a third syncs the queue to disk every
+ * --sync-ms. Frames left from an earlier run go first. Batches that fail
+ * are tried again, backing off up to a few seconds. Frames that don't fit
+ * in a full queue are dropped, and reported on stderr at most every 10s.
+ * At the end of stdin it waits for the queue to empty.
+ *
+ * With --bench it instead uploads a synthetic stream of frames to a stand-in
+ * server in the same process, which refuses uploads for the first --outage
+ * seconds as if the backhaul were down, and reports the rates frames went in
+ * and came out. Every frame must arrive once, in order.
+ *
+ * With --crash-test it runs the same in a child process and kills it with
+ * SIGKILL every so often, starting it again each time, then empties the
+ * queue. Every frame the child pushed must arrive, in order, though some
+ * arrive twice where a batch was uploaded but not popped.
+ *
+ * Usage: gw-upload file --to host:port [--path p] [--sync-ms n] [--size MB]
+ *        gw-upload file --bench [--frames n] [--outage s] [--size MB]
+ *        gw-upload file --crash-test [--rounds n] [--size MB]
+ * The exit status is 1 if the queue couldn't be opened or a check failed.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "frame.h"
+#include "queue.h"
+
+using namespace ukhasnet;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string file;
+    std::string host, port;
+    std::string path = "/upload";
+    unsigned sync_ms = 1000;
+    size_t size_mb = 64;
+    bool bench = false, crash_test = false;
+    uint64_t frames = 2000000;
+    double outage = 1;
+    unsigned rounds = 20;
+};
+
+Options opt;
+
+/* Frames and bytes in one upload */
+const size_t BATCH_FRAMES = 4096;
+const size_t BATCH_BYTES = 256 << 10;
+
+/* Most often frames dropped from a full queue are reported, in seconds */
+const double DROP_REPORT_S = 10;
+
+double since(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+void sleep_ms(unsigned ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool send_all(int fd, const char* p, size_t len)
+{
+    while(len)
+    {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if(n <= 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+/**
+ * Read one HTTP message's headers and body from fd, keeping anything after
+ * it in buf for the next.
+ * @returns false if the connection closed or the message was malformed
+ */
+bool read_message(int fd, std::string& buf, std::string& head,
+        std::string& body)
+{
+    size_t end, len = 0;
+    char tmp[65536];
+
+    while((end = buf.find("\r\n\r\n")) == std::string::npos)
+    {
+        ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+        if(n <= 0)
+            return false;
+        buf.append(tmp, n);
+    }
+    head = buf.substr(0, end);
+
+    std::string lower(head);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    size_t cl = lower.find("content-length:");
+    if(cl != std::string::npos)
+        len = std::strtoul(head.c_str() + cl + 15, nullptr, 10);
+
+    while(buf.size() < end + 4 + len)
+    {
+        ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+        if(n <= 0)
+            return false;
+        buf.append(tmp, n);
+    }
+    body = buf.substr(end + 4, len);
+    buf.erase(0, end + 4 + len);
+    return true;
+}
+
+/* HTTP/1.1 client keeping its connection open between POSTs */
+class Client {
+public:
+    Client(const std::string& h, const std::string& p) : host(h), port(p) {}
+    ~Client() { disconnect(); }
+
+    /* POST a body. Returns false unless the reply is 2xx. */
+    bool post(const std::string& path, const std::string& body)
+    {
+        std::string req, head, reply;
+
+        if(fd < 0 && !connect())
+            return false;
+
+        req = "POST " + path + " HTTP/1.1\r\nHost: " + host
+            + "\r\nContent-Type: text/plain\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\n\r\n";
+        if(!send_all(fd, req.data(), req.size())
+                || !send_all(fd, body.data(), body.size())
+                || !read_message(fd, buf, head, reply))
+        {
+            disconnect();
+            return false;
+        }
+
+        size_t sp = head.find(' ');
+        int status = sp == std::string::npos ? 0
+            : std::atoi(head.c_str() + sp + 1);
+        return status >= 200 && status < 300;
+    }
+
+private:
+    bool connect()
+    {
+        struct addrinfo hints, *res;
+
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_socktype = SOCK_STREAM;
+        if(getaddrinfo(host.c_str(), port.c_str(), &hints, &res))
+            return false;
+
+        for(struct addrinfo* a = res; a && fd < 0; a = a->ai_next)
+        {
+            fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if(fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) < 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(res);
+        buf.clear();
+        return fd >= 0;
+    }
+
+    void disconnect()
+    {
+        if(fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+
+    std::string host, port, buf;
+    int fd = -1;
+};
+
+/* Stand-in for an upload server on 127.0.0.1, passing each POST's body to
+ * handle() and replying with the status it returns */
+class StandIn {
+public:
+    std::function<int(const std::string&)> handle;
+
+    /* Returns the port, or 0 on an error */
+    unsigned start()
+    {
+        struct sockaddr_in a;
+        socklen_t len = sizeof(a);
+
+        std::memset(&a, 0, sizeof(a));
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        lfd = socket(AF_INET, SOCK_STREAM, 0);
+        if(lfd < 0 || bind(lfd, (struct sockaddr*)&a, sizeof(a)) < 0
+                || listen(lfd, 8) < 0
+                || getsockname(lfd, (struct sockaddr*)&a, &len) < 0)
+            return 0;
+
+        acceptor = std::thread([this]() {
+            int fd;
+            while((fd = accept(lfd, nullptr, nullptr)) >= 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                fds.push_back(fd);
+                conns.emplace_back([this, fd]() { serve(fd); });
+            }
+        });
+        return ntohs(a.sin_port);
+    }
+
+    void stop()
+    {
+        shutdown(lfd, SHUT_RDWR);
+        acceptor.join();
+        ::close(lfd);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int fd : fds)
+            shutdown(fd, SHUT_RDWR);
+        for(std::thread& t : conns)
+            t.join();
+        for(int fd : fds)
+            ::close(fd);
+    }
+
+private:
+    void serve(int fd)
+    {
+        std::string buf, head, body;
+
+        while(read_message(fd, buf, head, body))
+        {
+            int status = handle(body);
+            std::string reply = "HTTP/1.1 " + std::to_string(status)
+                + (status == 200 ? " OK" : " Service Unavailable")
+                + "\r\nContent-Length: 0\r\n\r\n";
+            if(!send_all(fd, reply.data(), reply.size()))
+                break;
+        }
+    }
+
+    int lfd = -1;
+    std::thread acceptor;
+    std::mutex mutex;
+    std::vector<int> fds;
+    std::vector<std::thread> conns;
+};
+
+/* Upload batches until told to stop, or with drain until the queue is
+ * empty as well */
+void uploader(Queue& q, Client& http, const std::atomic<bool>& stop,
+        bool drain, std::atomic<uint64_t>* batches)
+{
+    Batch b;
+    std::string body;
+    unsigned backoff = 50;
+
+    while(!stop || (drain && q.used()))
+    {
+        if(!q.peek(b, BATCH_FRAMES, BATCH_BYTES))
+        {
+            sleep_ms(5);
+            continue;
+        }
+
+        body.clear();
+        for(const std::string& f : b.frames)
+        {
+            body += f;
+            body += '\n';
+        }
+
+        if(http.post(opt.path, body))
+        {
+            q.pop(b);
+            backoff = 50;
+            if(batches)
+                (*batches)++;
+        }
+        else
+        {
+            sleep_ms(backoff);
+            backoff = std::min(backoff * 2, 4000u);
+        }
+    }
+}
+
+/* Report the frames dropped since the last report, if any */
+void report_drops(uint64_t dropped, uint64_t& reported,
+        Clock::time_point& last)
+{
+    if(dropped == reported)
+        return;
+    std::fprintf(stderr, "gw-upload: queue full, %llu frames dropped\n",
+            (unsigned long long)(dropped - reported));
+    reported = dropped;
+    last = Clock::now();
+}
+
+/* Sync the queue every --sync-ms, and report any frames dropped at most
+ * every DROP_REPORT_S */
+void syncer(Queue& q, const std::atomic<bool>& stop,
+        std::atomic<uint64_t>* syncs, const std::atomic<uint64_t>* dropped)
+{
+    uint64_t reported = 0;
+    Clock::time_point last = Clock::now()
+        - std::chrono::milliseconds((int)(1000 * DROP_REPORT_S));
+
+    while(!stop)
+    {
+        sleep_ms(opt.sync_ms);
+        if(!q.sync())
+            std::perror("gw-upload: sync");
+        else if(syncs)
+            (*syncs)++;
+
+        if(dropped && since(last) >= DROP_REPORT_S)
+            report_drops(dropped->load(), reported, last);
+    }
+    if(dropped)
+        report_drops(dropped->load(), reported, last);
+}
+
+bool open(Queue& q)
+{
+    if(!q.open(opt.file, opt.size_mb << 20))
+    {
+        std::fprintf(stderr, "gw-upload: can't open %s: %s\n",
+                opt.file.c_str(), std::strerror(errno));
+        return false;
+    }
+    if(q.recovered())
+        std::fprintf(stderr, "gw-upload: %llu frames left from last time\n",
+                (unsigned long long)q.recovered());
+    return true;
+}
+
+int upload()
+{
+    Queue q;
+    Client http(opt.host, opt.port);
+    std::atomic<bool> stop(false);
+    std::string line;
+    std::atomic<uint64_t> dropped(0);
+
+    if(!open(q))
+        return 1;
+
+    std::thread up([&]() { uploader(q, http, stop, true, nullptr); });
+    std::thread sync([&]() { syncer(q, stop, nullptr, &dropped); });
+
+    while(std::getline(std::cin, line))
+    {
+        if(!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        if(!line.empty() && !q.push(line))
+            dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    stop = true;
+    up.join();
+    sync.join();
+    q.sync();
+    return 0;
+}
+
+/* A frame carrying a sequence number in its Z field */
+std::string frame(uint64_t seq)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "2%cV%uT%.1fZ%llu[N%u,GW]",
+            'b' + (int)(seq % 25), 1100 + (unsigned)(seq % 400),
+            (seq % 300) / 10.0, (unsigned long long)seq,
+            (unsigned)(seq % 1000));
+    return buf;
+}
+
+/* What the stand-in has seen of the sequence numbers */
+struct Seen {
+    std::mutex mutex;
+    int64_t max = -1;
+    uint64_t frames = 0, dups = 0, gaps = 0;
+
+    void check(const std::string& body)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t p = 0, end;
+        Frame f;
+        double z;
+
+        while((end = body.find('\n', p)) != std::string::npos)
+        {
+            if(!parse(body.substr(p, end - p), f) || !field(f, 'Z', 0, z))
+                gaps++;
+            else if((int64_t)z <= max)
+                dups++;
+            else if((int64_t)z > max + 1)
+                gaps++;
+            if((int64_t)z > max)
+                max = (int64_t)z;
+            frames++;
+            p = end + 1;
+        }
+    }
+};
+
+int bench()
+{
+    StandIn server;
+    Seen seen;
+    Clock::time_point t0 = Clock::now();
+
+    server.handle = [&](const std::string& body) {
+        if(since(t0) < opt.outage)
+            return 503;
+        seen.check(body);
+        return 200;
+    };
+    unsigned port = server.start();
+    if(!port)
+    {
+        std::perror("gw-upload: stand-in server");
+        return 1;
+    }
+
+    std::remove(opt.file.c_str());
+    Queue q;
+    if(!open(q))
+        return 1;
+
+    Client http("127.0.0.1", std::to_string(port));
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> batches(0), syncs(0);
+    std::thread up([&]() { uploader(q, http, stop, true, &batches); });
+    std::thread sync([&]() { syncer(q, stop, &syncs, nullptr); });
+
+    /* Push as fast as possible, waiting only when the queue is full */
+    uint64_t full = 0, peak = 0;
+    std::vector<std::string> frames;
+    frames.reserve(opt.frames);
+    for(uint64_t i = 0; i < opt.frames; i++)
+        frames.push_back(frame(i));
+
+    t0 = Clock::now();
+    Clock::time_point p0 = Clock::now();
+    for(const std::string& f : frames)
+    {
+        while(!q.push(f))
+        {
+            full++;
+            std::this_thread::yield();
+        }
+        peak = std::max(peak, q.used());
+    }
+    double push_secs = since(p0);
+
+    stop = true;
+    up.join();
+    double total_secs = since(t0);
+    sync.join();
+    server.stop();
+
+    bool ok = seen.frames == opt.frames && !seen.dups && !seen.gaps
+        && seen.max + 1 == (int64_t)opt.frames;
+    std::printf("%llu frames pushed in %.2f s, %.2fM per s, waited for room "
+            "%llu times\n", (unsigned long long)opt.frames, push_secs,
+            opt.frames / push_secs / 1e6, (unsigned long long)full);
+    std::printf("uploaded in %llu batches by %.2f s, with a %.1f s outage, "
+            "%.2fM frames per s after it\n", (unsigned long long)batches.load(),
+            total_secs, opt.outage, opt.frames / (total_secs - opt.outage)
+            / 1e6);
+    std::printf("peak backlog %.1f MB, %llu syncs\n", peak / 1e6,
+            (unsigned long long)syncs.load());
+    std::printf("%llu frames arrived, %llu twice, %llu out of order  %s\n",
+            (unsigned long long)seen.frames, (unsigned long long)seen.dups,
+            (unsigned long long)seen.gaps, ok ? "ok" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/* The last sequence number pushed, in a file shared with the crash test */
+std::atomic<uint64_t>* pushed_counter(bool create)
+{
+    std::string path = opt.file + ".pushed";
+    int fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0),
+            0644);
+    void* p;
+
+    if(fd < 0 || ftruncate(fd, sizeof(uint64_t)) < 0)
+        return nullptr;
+    p = mmap(NULL, sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+            0);
+    ::close(fd);
+    return p == MAP_FAILED ? nullptr : (std::atomic<uint64_t>*)p;
+}
+
+/* The crash test's child: push numbered frames at about 50k per s until
+ * killed, counting them in the shared file after each */
+int worker()
+{
+    Queue q;
+    std::atomic<uint64_t>* pushed = pushed_counter(false);
+    Client http("127.0.0.1", opt.port);
+    std::atomic<bool> stop(false);
+
+    if(!pushed || !open(q))
+        return 1;
+
+    std::thread up([&]() { uploader(q, http, stop, false, nullptr); });
+    std::thread sync([&]() { syncer(q, stop, nullptr, nullptr); });
+
+    for(uint64_t seq = pushed->load() + 1; ; seq++)
+    {
+        while(!q.push(frame(seq)))
+            sleep_ms(1);
+        pushed->store(seq);
+        if(!(seq % 500))
+            sleep_ms(10);
+    }
+}
+
+int crash_test()
+{
+    StandIn server;
+    Seen seen;
+    server.handle = [&](const std::string& body) {
+        seen.check(body);
+        return 200;
+    };
+    unsigned port = server.start();
+    if(!port)
+    {
+        std::perror("gw-upload: stand-in server");
+        return 1;
+    }
+
+    std::remove(opt.file.c_str());
+    std::atomic<uint64_t>* pushed = pushed_counter(true);
+    if(!pushed)
+    {
+        std::perror("gw-upload: pushed counter");
+        return 1;
+    }
+    pushed->store((uint64_t)-1);
+
+    /* Start the child afresh each time, so it has no threads or locks
+     * from this process */
+    std::mt19937 rng(1);
+    std::string sport = std::to_string(port);
+    for(unsigned r = 0; r < opt.rounds; r++)
+    {
+        pid_t pid = fork();
+        if(!pid)
+        {
+            execl("/proc/self/exe", "gw-upload", opt.file.c_str(),
+                    "--worker", sport.c_str(),
+                    "--size", std::to_string(opt.size_mb).c_str(),
+                    (char*)NULL);
+            _exit(127);
+        }
+        sleep_ms(50 + rng() % 250);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+
+    /* Empty what's left */
+    Queue q;
+    if(!open(q))
+        return 1;
+    Client http("127.0.0.1", sport);
+    std::atomic<bool> stop(true);
+    uploader(q, http, stop, true, nullptr);
+    server.stop();
+
+    int64_t last = (int64_t)pushed->load();
+    bool ok = !seen.gaps && seen.max >= last && last > 0;
+    std::printf("%u kills, %lld frames pushed, %llu arrived, %llu twice, "
+            "%llu missing or out of order  %s\n", opt.rounds,
+            (long long)last + 1, (unsigned long long)seen.frames,
+            (unsigned long long)seen.dups, (unsigned long long)seen.gaps,
+            ok ? "ok" : "FAIL");
+
+    std::remove((opt.file + ".pushed").c_str());
+    return ok ? 0 : 1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: gw-upload file --to host:port [--path p] "
+            "[--sync-ms n] [--size MB]\n"
+            "       gw-upload file --bench [--frames n] [--outage s] "
+            "[--size MB]\n"
+            "       gw-upload file --crash-test [--rounds n] [--size MB]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool is_worker = false;
+
+    if(argc < 2)
+        usage();
+    opt.file = argv[1];
+
+    for(int i = 2; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--bench")
+            opt.bench = true;
+        else if(a == "--crash-test")
+            opt.crash_test = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--to")
+        {
+            std::string to(argv[++i]);
+            size_t colon = to.rfind(':');
+            if(colon == std::string::npos)
+                usage();
+            opt.host = to.substr(0, colon);
+            opt.port = to.substr(colon + 1);
+        }
+        else if(a == "--path")
+            opt.path = argv[++i];
+        else if(a == "--sync-ms")
+            opt.sync_ms = std::atoi(argv[++i]);
+        else if(a == "--size")
+            opt.size_mb = std::atoi(argv[++i]);
+        else if(a == "--frames")
+            opt.frames = std::atoll(argv[++i]);
+        else if(a == "--outage")
+            opt.outage = std::atof(argv[++i]);
+        else if(a == "--rounds")
+            opt.rounds = std::atoi(argv[++i]);
+        else if(a == "--worker")
+        {
+            is_worker = true;
+            opt.port = argv[++i];
+        }
+        else
+            usage();
+    }
+    if(!opt.sync_ms || !opt.size_mb || !opt.frames || !opt.rounds)
+        usage();
+
+    if(is_worker)
+        return worker();
+    if(opt.crash_test)
+        return crash_test();
+    if(opt.bench)
+        return bench();
+    if(opt.host.empty())
+        usage();
+    return upload();
+}
@@ -0,0 +1,223 @@
+/**
+ * Report the packet loss, reboots and beacon interval of every node heard
+ * (see health.h).
+ *
+ * Reads one packet per line on stdin, as the receive time in ms and the
+ * text packet separated by a space, and at the end prints each node's
+ * figures, worst recent delivery first. Malformed lines are reported on
+ * stderr and skipped.
+ *
+ * With --bench it instead runs a synthetic fleet whose nodes each lose a
+ * different share of their beacons and reboot now and then, reports the
+ * time taken per frame and checks every node's figures against the truth.
+ *
+ * Usage: gw-watch
+ *        gw-watch --bench [--nodes n] [--beacons n]
+ * The exit status is 1 if any line was malformed or the bench check failed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "health.h"
+
+using namespace ukhasnet;
+
+namespace {
+
+/* Furthest a node's delivery may be from its true value in the bench, in
+ * standard deviations of the weighted average's noise */
+const double DELIVERY_SIGMAS = 7;
+
+struct Options {
+    bool bench = false;
+    unsigned nodes = 10000;
+    unsigned beacons = 500;
+};
+
+Options opt;
+
+int watch()
+{
+    Health health;
+    std::vector<NodeHealth> nodes;
+    std::string line, text;
+    int status = 0;
+
+    while(std::getline(std::cin, line))
+    {
+        std::istringstream in(line);
+        uint64_t t;
+        Frame f;
+
+        if(line.empty())
+            continue;
+        if(!(in >> t >> text) || !parse(text, f) || !health.add(f, t))
+        {
+            std::fprintf(stderr, "gw-watch: malformed line %s\n",
+                    line.c_str());
+            status = 1;
+        }
+    }
+
+    health.all(nodes);
+    std::sort(nodes.begin(), nodes.end(),
+            [](const NodeHealth& a, const NodeHealth& b) {
+                return a.delivery < b.delivery;
+            });
+
+    std::printf("%-15s %7s %7s %7s %8s %9s\n", "node", "frames", "lost",
+            "reboots", "delivery", "interval");
+    for(const NodeHealth& h : nodes)
+        std::printf("%-15s %7u %7u %7u %7.1f%% %8.1fs\n", h.node.c_str(),
+                h.frames, h.lost, h.reboots, 100 * h.delivery, h.interval);
+
+    return status;
+}
+
+/* A node in the synthetic fleet */
+struct Node {
+    std::string id;
+    double loss;            // Share of beacons lost
+    double interval;        // ms
+    unsigned sent, got, reboots;
+    char seqid;
+    char resume;            // ID after the next 'a'
+};
+
+/* A beacon as a gateway receives it */
+struct Beacon {
+    uint64_t ms;
+    uint32_t node;
+    char seqid;
+};
+
+int bench()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<Node> fleet(opt.nodes);
+    std::vector<Beacon> heard;
+    bool ok = true;
+
+    /* Nodes beacon every 30s to 5 minutes, losing 0 to 60% */
+    for(unsigned i = 0; i < opt.nodes; i++)
+    {
+        Node& n = fleet[i];
+        n.id = "N" + std::to_string(i);
+        n.loss = 0.6 * u(rng) * u(rng);
+        n.interval = 30000 + 270000 * u(rng);
+        n.sent = n.got = n.reboots = 0;
+        n.seqid = 'a';
+        n.resume = 'b';
+
+        double t = n.interval * u(rng);
+        for(unsigned b = 0; b < opt.beacons; b++)
+        {
+            /* Reboot about once in 300 beacons, carrying on after the 'a'
+             * from up to 16 IDs ahead, as fc-node3 does from its lease */
+            if(b && u(rng) < 1.0 / 300)
+            {
+                n.resume = 'b' + (n.seqid - 'b' + (int)(16 * u(rng))) % 25;
+                n.seqid = 'a';
+                n.reboots++;
+            }
+            if(!b || u(rng) >= n.loss || n.seqid == 'a')
+            {
+                heard.push_back(Beacon{ (uint64_t)t, i, n.seqid });
+                n.got++;
+            }
+            n.sent++;
+            if(n.seqid == 'a')
+                n.seqid = n.resume;
+            else
+                n.seqid = n.seqid == 'z' ? 'b' : n.seqid + 1;
+            t += n.interval * (0.98 + 0.04 * u(rng));
+        }
+    }
+    std::sort(heard.begin(), heard.end(),
+            [](const Beacon& a, const Beacon& b) { return a.ms < b.ms; });
+
+    Health health(opt.nodes);
+    auto t0 = std::chrono::steady_clock::now();
+    for(const Beacon& b : heard)
+        health.add(fleet[b.node].id, b.seqid, b.ms);
+    double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+
+    /* The counts must match, apart from beacons lost before a reboot, which
+     * can't be told. Delivery is over the last few dozen beacons only, so
+     * each node's is noisy, but it must be right on average, and no node's
+     * may be further out than DELIVERY_SIGMAS standard deviations of that
+     * noise. */
+    unsigned bad = 0;
+    double err = 0, worst = 0, worst_sigmas = 0;
+    for(const Node& n : fleet)
+    {
+        NodeHealth h;
+        if(!health.get(n.id, h) || h.frames != n.got
+                || h.reboots != n.reboots
+                || h.frames + h.lost > n.sent
+                || std::fabs(h.interval * 1000 - n.interval)
+                    > 0.05 * n.interval)
+        {
+            bad++;
+            continue;
+        }
+        double p = 1 - n.loss;
+        double e = std::fabs(h.delivery - p);
+        double sd = std::sqrt(p * (1 - p) / (2 * HEALTH_WINDOW - 1));
+        err += e / opt.nodes;
+        worst = std::max(worst, e);
+        worst_sigmas = std::max(worst_sigmas, e / std::max(sd, 0.01));
+    }
+    if(bad || err > 0.05 || worst_sigmas > DELIVERY_SIGMAS)
+        ok = false;
+
+    std::printf("%zu frames from %u nodes, %.0f ns per frame\n",
+            heard.size(), opt.nodes, 1e9 * secs / heard.size());
+    std::printf("%u nodes with wrong counts, delivery error %.1f points on "
+            "average, %.1f at worst, %.1f standard deviations  %s\n", bad,
+            100 * err, 100 * worst, worst_sigmas, ok ? "ok" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: gw-watch\n"
+            "       gw-watch --bench [--nodes n] [--beacons n]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--bench")
+            opt.bench = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--nodes")
+            opt.nodes = std::atoi(argv[++i]);
+        else if(a == "--beacons")
+            opt.beacons = std::atoi(argv[++i]);
+        else
+            usage();
+    }
+    if(!opt.nodes || !opt.beacons)
+        usage();
+
+    return opt.bench ? bench() : watch();
+}
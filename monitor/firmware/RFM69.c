@@ -0,0 +1,276 @@
+// RFM69.c
+//
+// Ported to Arduino 2014 James Coxon
+//
+// Ported to bare metal AVR 2014 Jon Sowman
+//
+// Ported to ChibiOS on the STM32F030 for the RGB node and monitor
+//
+// Copyright (C) 2014 Phil Crump
+// Copyright (C) 2014 Jon Sowman <jon@jonsowman.com>
+//
+// Based on RF22 Copyright (C) 2011 Mike McCauley ported to mbed by Karl Zweimueller
+// Based on RFM69 LowPowerLabs (https://github.com/LowPowerLab/RFM69/)
+
+#include "hal.h"
+#include "nil.h"
+
+#include "RFM69.h"
+#include "RFM69Config.h"
+
+/**
+ * SPI1 in mode 0 at PCLK/8, 8 bit frames, with the RFM69 NSS on PA1. The
+ * display shares the bus and this configuration, selecting itself by hand.
+ */
+static const SPIConfig spi_config = {
+    NULL,
+    GPIOA,
+    GPIOA_RFM_CS,
+    SPI_CR1_BR_1,
+    SPI_CR2_DS_2 | SPI_CR2_DS_1 | SPI_CR2_DS_0
+};
+
+/** The SPI driver the RFM69 is attached to */
+static SPIDriver* _spi;
+
+/** Track the current mode of the radio */
+static uint8_t _mode;
+
+/** RSSI of the last packet received */
+static int16_t _lastRssi;
+
+/** Frequency error of the last packet received */
+static int16_t _lastFei;
+
+/**
+ * Initialise the RFM69 device.
+ * @param spip The SPI driver that the RFM69 is connected to
+ * @returns 0 on failure, nonzero on success
+ */
+bool rf69_init(SPIDriver* spip)
+{
+    uint8_t i;
+
+    _spi = spip;
+    spiStart(_spi, &spi_config);
+
+    chThdSleepMilliseconds(10);
+
+    // Set up device
+    for(i = 0; CONFIG[i][0] != 255; i++)
+        rf69_spiWrite(CONFIG[i][0], CONFIG[i][1]);
+
+    /* Set initial mode */
+    _mode = RFM69_MODE_RX;
+    rf69_setMode(_mode);
+
+    chThdSleepMilliseconds(5);
+
+    // Zero version number, RFM probably not connected/functioning
+    if(rf69_spiRead(RFM69_REG_10_VERSION) != 0x24)
+        return false;
+
+    return true;
+}
+
+/**
+ * Read a single byte from a register in the RFM69. Transmit the (one byte)
+ * address of the register to be read, then read the (one byte) response.
+ * @param reg The register address to be read
+ * @returns The value of the register
+ */
+uint8_t rf69_spiRead(const uint8_t reg)
+{
+    uint8_t data;
+
+    spiSelect(_spi);
+    spiPolledExchange(_spi, reg & ~RFM69_SPI_WRITE_MASK);
+    data = spiPolledExchange(_spi, 0xFF);
+    spiUnselect(_spi);
+
+    return data;
+}
+
+/**
+ * Write a single byte to a register in the RFM69. Transmit the register
+ * address (one byte) with the write mask RFM_SPI_WRITE_MASK on, and then the
+ * value of the register to be written.
+ * @param reg The address of the register to write
+ * @param val The value for the address
+ */
+void rf69_spiWrite(const uint8_t reg, const uint8_t val)
+{
+    spiSelect(_spi);
+    spiPolledExchange(_spi, reg | RFM69_SPI_WRITE_MASK);
+    spiPolledExchange(_spi, val);
+    spiUnselect(_spi);
+}
+
+/**
+ * Read a given number of bytes from the given register address into a provided
+ * buffer
+ * @param reg The address of the register to start from
+ * @param dest A pointer into the destination buffer
+ * @param len The number of bytes to read
+ */
+void rf69_spiBurstRead(const uint8_t reg, uint8_t* dest, uint8_t len)
+{
+    spiSelect(_spi);
+    spiPolledExchange(_spi, reg & ~RFM69_SPI_WRITE_MASK);
+    while(len--)
+        *dest++ = spiPolledExchange(_spi, 0xFF);
+    spiUnselect(_spi);
+}
+
+/**
+ * Write a given number of bytes into the registers in the RFM69.
+ * @param reg The first byte address into which to write
+ * @param src A pointer into the source data buffer
+ * @param len The number of bytes to write
+ */
+void rf69_spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len)
+{
+    spiSelect(_spi);
+    spiPolledExchange(_spi, reg | RFM69_SPI_WRITE_MASK);
+    while(len--)
+        spiPolledExchange(_spi, *src++);
+    spiUnselect(_spi);
+}
+
+/**
+ * Write data into the FIFO on the RFM69
+ * @param src The source data comes from this buffer
+ * @param len Write this number of bytes from the buffer into the FIFO
+ */
+void rf69_spiFifoWrite(const uint8_t* src, uint8_t len)
+{
+    spiSelect(_spi);
+    spiPolledExchange(_spi, RFM69_REG_00_FIFO | RFM69_SPI_WRITE_MASK);
+
+    // First byte is packet length
+    spiPolledExchange(_spi, len);
+
+    // Then write the packet
+    while(len--)
+        spiPolledExchange(_spi, *src++);
+    spiUnselect(_spi);
+}
+
+/**
+ * Change the RFM69 operating mode to a new one.
+ * @param newMode The value representing the new mode (see datasheet for
+ * further information).
+ */
+void rf69_setMode(const uint8_t newMode)
+{
+    rf69_spiWrite(RFM69_REG_01_OPMODE, newMode);
+    _mode = newMode;
+}
+
+/**
+ * Send a packet using the RFM69 radio.
+ * @param data The data buffer that contains the string to transmit
+ * @param len The number of bytes in the data packet (excluding preamble, sync
+ * and checksum)
+ * @param power The transmit power to be used in dBm
+ */
+void rf69_send(const uint8_t* data, uint8_t len, uint8_t power)
+{
+    uint8_t oldMode, timeout;
+
+    // power is TX Power in dBmW (valid values are 2dBmW-13dBmW on PA1)
+    if(power < 2 || power > 13)
+        return;
+
+    oldMode = _mode;
+
+    // Start Transmitter
+    rf69_setMode(RFM69_MODE_TX);
+
+    // Set PA Level
+    rf69_spiWrite(RFM69_REG_11_PA_LEVEL,
+            RF_PALEVEL_PA0_OFF | RF_PALEVEL_PA1_ON | RF_PALEVEL_PA2_OFF | (power + 18));
+
+    // Wait for PA ramp-up
+    timeout = 255;
+    while(!(rf69_spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_TXREADY)
+            && timeout--)
+        chThdSleepMilliseconds(1);
+
+    // Throw Buffer into FIFO, packet transmission will start automatically
+    rf69_spiFifoWrite(data, len);
+
+    // Wait for packet to be sent
+    timeout = 255;
+    while(!(rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2) & RF_IRQFLAGS2_PACKETSENT)
+            && timeout--)
+        chThdSleepMilliseconds(5);
+
+    // Return Transceiver to original mode
+    rf69_setMode(oldMode);
+}
+
+/**
+ * Check for a received packet and if there is one, copy it out of the FIFO.
+ * The DIO pins are not wired to the MCU on this board, so this is polled.
+ * @param buf Destination for the packet, at least RFM69_MAX_MESSAGE_LEN bytes
+ * @param len Set to the length of the packet
+ * @returns true if a packet was received
+ */
+bool rf69_receive(uint8_t* buf, uint8_t* len)
+{
+    uint8_t n;
+
+    if(!(rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2) & RF_IRQFLAGS2_PAYLOADREADY))
+        return false;
+
+    _lastRssi = -(rf69_spiRead(RFM69_REG_24_RSSI_VALUE) / 2);
+    _lastFei = (int16_t)((rf69_spiRead(RFM69_REG_1F_AFC_MSB) << 8)
+            | rf69_spiRead(RFM69_REG_20_AFC_LSB));
+
+    spiSelect(_spi);
+    spiPolledExchange(_spi, RFM69_REG_00_FIFO);
+
+    // First byte is the packet length
+    n = spiPolledExchange(_spi, 0xFF);
+    if(n > RFM69_MAX_MESSAGE_LEN)
+        n = RFM69_MAX_MESSAGE_LEN;
+
+    *len = n;
+    while(n--)
+        *buf++ = spiPolledExchange(_spi, 0xFF);
+    spiUnselect(_spi);
+
+    return true;
+}
+
+/**
+ * Clear the FIFO in the RFM69. We do this by entering STBY mode and then
+ * returing to RX mode.
+ * @warning Must only be called in RX Mode
+ * @note Apparently this works... found in HopeRF demo code
+ */
+void rf69_clearFifo(void)
+{
+    rf69_setMode(RFM69_MODE_STDBY);
+    rf69_setMode(RFM69_MODE_RX);
+}
+
+/**
+ * @returns The RSSI of the last packet returned by rf69_receive() in dBm
+ */
+int16_t rf69_lastRssi(void)
+{
+    return _lastRssi;
+}
+
+/**
+ * With automatic AFC on, the correction the radio applied at the start of
+ * the packet is the frequency error measured against the transmitter.
+ * @returns The frequency error of the last packet returned by
+ * rf69_receive() in 61.035Hz steps
+ */
+int16_t rf69_lastFei(void)
+{
+    return _lastFei;
+}
@@ -0,0 +1,270 @@
+/**
+ * Text driver for the 0.96" 128x64 SSD1306 OLED on the monitor boards.
+ * See display.h.
+ *
+ * The display shares SPI1 with the RFM69 and is wired for 4-wire SPI, with
+ * D0 on SCK and D1 on MOSI. It uses the bus as configured by rf69_init()
+ * and drives its own chip select.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "nil.h"
+
+#include "display.h"
+
+/* Glyphs are 5 columns wide, with a blank column after each */
+#define FONT_WIDTH          5
+#define CHAR_WIDTH          6
+
+/* SSD1306 commands */
+#define SSD1306_MEMORY_MODE     0x20
+#define SSD1306_COLUMN_ADDR     0x21
+#define SSD1306_PAGE_ADDR       0x22
+#define SSD1306_START_LINE      0x40
+#define SSD1306_CONTRAST        0x81
+#define SSD1306_CHARGE_PUMP     0x8D
+#define SSD1306_SEG_REMAP       0xA1
+#define SSD1306_DISPLAY_RAM     0xA4
+#define SSD1306_NORMAL          0xA6
+#define SSD1306_MULTIPLEX       0xA8
+#define SSD1306_DISPLAY_OFF     0xAE
+#define SSD1306_DISPLAY_ON      0xAF
+#define SSD1306_COM_SCAN_DEC    0xC8
+#define SSD1306_DISPLAY_OFFSET  0xD3
+#define SSD1306_CLOCK_DIV       0xD5
+#define SSD1306_PRECHARGE       0xD9
+#define SSD1306_COM_PINS        0xDA
+#define SSD1306_VCOMH_DESELECT  0xDB
+
+static const uint8_t init_cmds[] = {
+    SSD1306_DISPLAY_OFF,
+    SSD1306_CLOCK_DIV, 0x80,
+    SSD1306_MULTIPLEX, 0x3F,
+    SSD1306_DISPLAY_OFFSET, 0x00,
+    SSD1306_START_LINE | 0x00,
+    SSD1306_CHARGE_PUMP, 0x14,          // Internal charge pump
+    SSD1306_MEMORY_MODE, 0x00,          // Horizontal addressing
+    SSD1306_SEG_REMAP,
+    SSD1306_COM_SCAN_DEC,
+    SSD1306_COM_PINS, 0x12,
+    SSD1306_CONTRAST, 0xCF,
+    SSD1306_PRECHARGE, 0xF1,
+    SSD1306_VCOMH_DESELECT, 0x40,
+    SSD1306_DISPLAY_RAM,
+    SSD1306_NORMAL,
+    SSD1306_DISPLAY_ON
+};
+
+/**
+ * 5x7 font for ASCII 0x20 to 0x7E. Each glyph is 5 columns, LSB at the top,
+ * which is the SSD1306 page layout so glyphs are copied straight out.
+ */
+static const uint8_t font[][FONT_WIDTH] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 },   /* space */
+    { 0x00, 0x00, 0x5F, 0x00, 0x00 },   /* ! */
+    { 0x00, 0x07, 0x00, 0x07, 0x00 },   /* " */
+    { 0x14, 0x7F, 0x14, 0x7F, 0x14 },   /* # */
+    { 0x24, 0x2A, 0x7F, 0x2A, 0x12 },   /* $ */
+    { 0x23, 0x13, 0x08, 0x64, 0x62 },   /* % */
+    { 0x36, 0x49, 0x55, 0x22, 0x50 },   /* & */
+    { 0x00, 0x05, 0x03, 0x00, 0x00 },   /* ' */
+    { 0x00, 0x1C, 0x22, 0x41, 0x00 },   /* ( */
+    { 0x00, 0x41, 0x22, 0x1C, 0x00 },   /* ) */
+    { 0x08, 0x2A, 0x1C, 0x2A, 0x08 },   /* * */
+    { 0x08, 0x08, 0x3E, 0x08, 0x08 },   /* + */
+    { 0x00, 0x50, 0x30, 0x00, 0x00 },   /* , */
+    { 0x08, 0x08, 0x08, 0x08, 0x08 },   /* - */
+    { 0x00, 0x60, 0x60, 0x00, 0x00 },   /* . */
+    { 0x20, 0x10, 0x08, 0x04, 0x02 },   /* / */
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E },   /* 0 */
+    { 0x00, 0x42, 0x7F, 0x40, 0x00 },   /* 1 */
+    { 0x42, 0x61, 0x51, 0x49, 0x46 },   /* 2 */
+    { 0x21, 0x41, 0x45, 0x4B, 0x31 },   /* 3 */
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 },   /* 4 */
+    { 0x27, 0x45, 0x45, 0x45, 0x39 },   /* 5 */
+    { 0x3C, 0x4A, 0x49, 0x49, 0x30 },   /* 6 */
+    { 0x01, 0x71, 0x09, 0x05, 0x03 },   /* 7 */
+    { 0x36, 0x49, 0x49, 0x49, 0x36 },   /* 8 */
+    { 0x06, 0x49, 0x49, 0x29, 0x1E },   /* 9 */
+    { 0x00, 0x36, 0x36, 0x00, 0x00 },   /* : */
+    { 0x00, 0x56, 0x36, 0x00, 0x00 },   /* ; */
+    { 0x00, 0x08, 0x14, 0x22, 0x41 },   /* < */
+    { 0x14, 0x14, 0x14, 0x14, 0x14 },   /* = */
+    { 0x41, 0x22, 0x14, 0x08, 0x00 },   /* > */
+    { 0x02, 0x01, 0x51, 0x09, 0x06 },   /* ? */
+    { 0x32, 0x49, 0x79, 0x41, 0x3E },   /* @ */
+    { 0x7E, 0x11, 0x11, 0x11, 0x7E },   /* A */
+    { 0x7F, 0x49, 0x49, 0x49, 0x36 },   /* B */
+    { 0x3E, 0x41, 0x41, 0x41, 0x22 },   /* C */
+    { 0x7F, 0x41, 0x41, 0x22, 0x1C },   /* D */
+    { 0x7F, 0x49, 0x49, 0x49, 0x41 },   /* E */
+    { 0x7F, 0x09, 0x09, 0x01, 0x01 },   /* F */
+    { 0x3E, 0x41, 0x41, 0x51, 0x32 },   /* G */
+    { 0x7F, 0x08, 0x08, 0x08, 0x7F },   /* H */
+    { 0x00, 0x41, 0x7F, 0x41, 0x00 },   /* I */
+    { 0x20, 0x40, 0x41, 0x3F, 0x01 },   /* J */
+    { 0x7F, 0x08, 0x14, 0x22, 0x41 },   /* K */
+    { 0x7F, 0x40, 0x40, 0x40, 0x40 },   /* L */
+    { 0x7F, 0x02, 0x04, 0x02, 0x7F },   /* M */
+    { 0x7F, 0x04, 0x08, 0x10, 0x7F },   /* N */
+    { 0x3E, 0x41, 0x41, 0x41, 0x3E },   /* O */
+    { 0x7F, 0x09, 0x09, 0x09, 0x06 },   /* P */
+    { 0x3E, 0x41, 0x51, 0x21, 0x5E },   /* Q */
+    { 0x7F, 0x09, 0x19, 0x29, 0x46 },   /* R */
+    { 0x46, 0x49, 0x49, 0x49, 0x31 },   /* S */
+    { 0x01, 0x01, 0x7F, 0x01, 0x01 },   /* T */
+    { 0x3F, 0x40, 0x40, 0x40, 0x3F },   /* U */
+    { 0x1F, 0x20, 0x40, 0x20, 0x1F },   /* V */
+    { 0x7F, 0x20, 0x18, 0x20, 0x7F },   /* W */
+    { 0x63, 0x14, 0x08, 0x14, 0x63 },   /* X */
+    { 0x03, 0x04, 0x78, 0x04, 0x03 },   /* Y */
+    { 0x61, 0x51, 0x49, 0x45, 0x43 },   /* Z */
+    { 0x00, 0x00, 0x7F, 0x41, 0x41 },   /* [ */
+    { 0x02, 0x04, 0x08, 0x10, 0x20 },   /* backslash */
+    { 0x41, 0x41, 0x7F, 0x00, 0x00 },   /* ] */
+    { 0x04, 0x02, 0x01, 0x02, 0x04 },   /* ^ */
+    { 0x40, 0x40, 0x40, 0x40, 0x40 },   /* _ */
+    { 0x00, 0x01, 0x02, 0x04, 0x00 },   /* ` */
+    { 0x20, 0x54, 0x54, 0x54, 0x78 },   /* a */
+    { 0x7F, 0x48, 0x44, 0x44, 0x38 },   /* b */
+    { 0x38, 0x44, 0x44, 0x44, 0x20 },   /* c */
+    { 0x38, 0x44, 0x44, 0x48, 0x7F },   /* d */
+    { 0x38, 0x54, 0x54, 0x54, 0x18 },   /* e */
+    { 0x08, 0x7E, 0x09, 0x01, 0x02 },   /* f */
+    { 0x08, 0x14, 0x54, 0x54, 0x3C },   /* g */
+    { 0x7F, 0x08, 0x04, 0x04, 0x78 },   /* h */
+    { 0x00, 0x44, 0x7D, 0x40, 0x00 },   /* i */
+    { 0x20, 0x40, 0x44, 0x3D, 0x00 },   /* j */
+    { 0x00, 0x7F, 0x10, 0x28, 0x44 },   /* k */
+    { 0x00, 0x41, 0x7F, 0x40, 0x00 },   /* l */
+    { 0x7C, 0x04, 0x18, 0x04, 0x78 },   /* m */
+    { 0x7C, 0x08, 0x04, 0x04, 0x78 },   /* n */
+    { 0x38, 0x44, 0x44, 0x44, 0x38 },   /* o */
+    { 0x7C, 0x14, 0x14, 0x14, 0x08 },   /* p */
+    { 0x08, 0x14, 0x14, 0x18, 0x7C },   /* q */
+    { 0x7C, 0x08, 0x04, 0x04, 0x08 },   /* r */
+    { 0x48, 0x54, 0x54, 0x54, 0x20 },   /* s */
+    { 0x04, 0x3F, 0x44, 0x40, 0x20 },   /* t */
+    { 0x3C, 0x40, 0x40, 0x20, 0x7C },   /* u */
+    { 0x1C, 0x20, 0x40, 0x20, 0x1C },   /* v */
+    { 0x3C, 0x40, 0x30, 0x40, 0x3C },   /* w */
+    { 0x44, 0x28, 0x10, 0x28, 0x44 },   /* x */
+    { 0x0C, 0x50, 0x50, 0x50, 0x3C },   /* y */
+    { 0x44, 0x64, 0x54, 0x4C, 0x44 },   /* z */
+    { 0x00, 0x08, 0x36, 0x41, 0x00 },   /* { */
+    { 0x00, 0x00, 0x7F, 0x00, 0x00 },   /* | */
+    { 0x00, 0x41, 0x36, 0x08, 0x00 },   /* } */
+    { 0x02, 0x01, 0x02, 0x04, 0x02 }    /* ~ */
+};
+
+static SPIDriver* _spi;
+
+/* The text we want on each row, and a bit set for each row to redraw */
+static char lines[DISPLAY_ROWS][DISPLAY_COLS];
+static uint8_t dirty;
+
+/**
+ * Send a sequence of bytes as either commands or display data.
+ * @param data True to send display data, false for commands
+ * @param buf The bytes to send
+ * @param len The number of bytes
+ */
+static void display_send(bool data, const uint8_t* buf, uint16_t len)
+{
+    if(data)
+        palSetPad(GPIOA, GPIOA_DISPLAY_DC);
+    else
+        palClearPad(GPIOA, GPIOA_DISPLAY_DC);
+
+    palClearPad(GPIOA, GPIOA_DISPLAY_CS);
+    while(len--)
+        spiPolledExchange(_spi, *buf++);
+    palSetPad(GPIOA, GPIOA_DISPLAY_CS);
+}
+
+/**
+ * Reset and configure the display, and blank it.
+ * @param spip The SPI driver, already started by rf69_init()
+ */
+void display_init(SPIDriver* spip)
+{
+    uint8_t i;
+
+    _spi = spip;
+
+    palClearPad(GPIOA, GPIOA_DISPLAY_RST);
+    chThdSleepMilliseconds(1);
+    palSetPad(GPIOA, GPIOA_DISPLAY_RST);
+    chThdSleepMilliseconds(1);
+
+    display_send(false, init_cmds, sizeof(init_cmds));
+
+    // Draw every row once to clear whatever is in the display RAM
+    memset(lines, ' ', sizeof(lines));
+    dirty = 0xFF;
+    for(i = 0; i < DISPLAY_ROWS; i++)
+        display_refresh();
+}
+
+/**
+ * Set the text of a row. Nothing is sent to the display here, the row is
+ * only marked to be redrawn by display_refresh() if the text has changed.
+ * @param row The row, 0 at the top
+ * @param text The text, truncated to DISPLAY_COLS and padded with spaces
+ */
+void display_setLine(uint8_t row, const char* text)
+{
+    char line[DISPLAY_COLS];
+    uint8_t i;
+
+    for(i = 0; i < DISPLAY_COLS && *text; i++)
+        line[i] = *text++;
+    for(; i < DISPLAY_COLS; i++)
+        line[i] = ' ';
+
+    if(memcmp(line, lines[row], DISPLAY_COLS))
+    {
+        memcpy(lines[row], line, DISPLAY_COLS);
+        dirty |= 1 << row;
+    }
+}
+
+/**
+ * Redraw the top row that has changed, if any.
+ * @returns true if there are still rows waiting to be redrawn
+ */
+bool display_refresh(void)
+{
+    uint8_t cmds[6];
+    uint8_t col[CHAR_WIDTH];
+    uint8_t row, i;
+    char c;
+
+    if(!dirty)
+        return false;
+
+    for(row = 0; !(dirty & (1 << row)); row++);
+    dirty &= ~(1 << row);
+
+    cmds[0] = SSD1306_COLUMN_ADDR;
+    cmds[1] = 0;
+    cmds[2] = DISPLAY_COLS * CHAR_WIDTH - 1;
+    cmds[3] = SSD1306_PAGE_ADDR;
+    cmds[4] = row;
+    cmds[5] = row;
+    display_send(false, cmds, sizeof(cmds));
+
+    col[FONT_WIDTH] = 0;
+    for(i = 0; i < DISPLAY_COLS; i++)
+    {
+        c = lines[row][i];
+        if(c < ' ' || c > '~')
+            c = '?';
+        memcpy(col, font[c - ' '], FONT_WIDTH);
+        display_send(true, col, CHAR_WIDTH);
+    }
+
+    return dirty != 0;
+}
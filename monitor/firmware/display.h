@@ -0,0 +1,24 @@
+/**
+ * Text driver for the 0.96" 128x64 SSD1306 OLED on the monitor boards.
+ *
+ * The display is treated as 8 rows of 21 characters, one row per SSD1306
+ * page. Rows are only redrawn when their text changes, and then one at a
+ * time so that the caller can service the radio in between.
+ */
+
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal.h"
+
+#define DISPLAY_ROWS        8
+#define DISPLAY_COLS        21
+
+void display_init(SPIDriver* spip);
+void display_setLine(uint8_t row, const char* text);
+bool display_refresh(void);
+
+#endif /* __DISPLAY_H__ */
@@ -0,0 +1,353 @@
+/**
+ * UKHASnet monitor
+ *
+ * Always-on receiver for the monitor and monitor-module boards. Every packet
+ * heard is stamped with its RSSI, frequency error and receive time, queued
+ * in a lock-free ring and passed up to the ESP8266 over the UART in
+ * length-prefixed batches (see uplink.h). The display shows the packet and
+ * error counters and the last packet heard.
+ *
+ * The radio thread has the highest priority and is woken by the RFM69's
+ * PayloadReady on DIO0. It only ever reads the FIFO into the ring, so it
+ * keeps up regardless of what the uplink is doing. The uplink thread empties
+ * the ring into a batch and sends it by DMA; whatever arrives while that is
+ * in progress goes in the next batch, so batches grow with the packet rate.
+ *
+ * DIO0 is not routed to the STM32 on either PCB. Fit a wire from the RFM69
+ * DIO0 pin to PA0 for interrupt driven reception, otherwise the pulldown on
+ * PA0 holds it low and the radio is polled every RADIO_POLL_MS instead.
+ *
+ * https://ukhas.net
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "nil.h"
+
+#include "RFM69.h"
+
+#include "display.h"
+#include "ring.h"
+#include "uplink.h"
+
+/* Radio poll period if DIO0 is not wired (ms) */
+#define RADIO_POLL_MS   5
+
+/* ESP8266 UART baud rate */
+#define UPLINK_BAUD     115200
+
+#if FRAME_MAX_LEN < RFM69_MAX_MESSAGE_LEN
+#error "FRAME_MAX_LEN is too small for the largest RFM69 packet"
+#endif
+
+static ring_t ring;
+static uplink_batch_t batch;
+
+/* Where frames go when the ring is full, so the radio is always drained */
+static frame_t discard;
+
+/* Counters, written by the radio thread only */
+static volatile uint32_t rx_count;
+static volatile uint32_t ring_overflows;
+static volatile uint32_t fifo_overruns;
+
+/* Threads waiting on DIO0, new frames and the end of a UART transfer */
+static thread_reference_t radio_trp;
+static thread_reference_t uplink_trp;
+static thread_reference_t tx_trp;
+
+/* The 16 bit system time extended to ms since boot */
+static systime_t last_tick;
+static uint32_t tick_rem;
+static uint32_t now_ms;
+
+/**
+ * The RFM69 DIO0 (PayloadReady) interrupt on PA0, via EXTI0.
+ */
+OSAL_IRQ_HANDLER(Vector54) {
+    OSAL_IRQ_PROLOGUE();
+
+    EXTI->PR = EXTI_PR_PR0;
+
+    osalSysLockFromISR();
+    chThdResumeI(&radio_trp, MSG_OK);
+    osalSysUnlockFromISR();
+
+    OSAL_IRQ_EPILOGUE();
+}
+
+/**
+ * Called when the DMA has handed the last byte of a batch to the UART.
+ */
+static void uplink_txend(UARTDriver* uartp)
+{
+    (void)uartp;
+
+    osalSysLockFromISR();
+    chThdResumeI(&tx_trp, MSG_OK);
+    osalSysUnlockFromISR();
+}
+
+static const UARTConfig uart_config = {
+    uplink_txend,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    UPLINK_BAUD,
+    0,
+    USART_CR2_STOP1_BITS,
+    0
+};
+
+/**
+ * Route PA0 to EXTI0 and interrupt on its rising edge.
+ */
+static void dio0_init(void)
+{
+    SYSCFG->EXTICR[0] &= ~SYSCFG_EXTICR1_EXTI0;
+    EXTI->RTSR |= EXTI_RTSR_TR0;
+    EXTI->IMR |= EXTI_IMR_MR0;
+    nvicEnableVector(EXTI0_1_IRQn, 3);
+}
+
+/**
+ * Must be called at least once per system time wrap, which is every 6.5s at
+ * 16 bits and 10kHz. The radio thread never sleeps for longer than that.
+ * @returns The time in ms since boot
+ */
+static uint32_t timestamp(void)
+{
+    systime_t now = chVTGetSystemTimeX();
+
+    tick_rem += (systime_t)(now - last_tick);
+    last_tick = now;
+
+    now_ms += tick_rem / (NIL_CFG_ST_FREQUENCY / 1000);
+    tick_rem %= NIL_CFG_ST_FREQUENCY / 1000;
+
+    return now_ms;
+}
+
+/**
+ * Write a signed value in decimal.
+ * @param p Where to write it
+ * @param v The value
+ * @returns A pointer to the character after the last digit
+ */
+static char* fmt_num(char* p, int32_t v)
+{
+    char buf[11];
+    uint32_t u = v < 0 ? -v : v;
+    uint8_t n = 0;
+
+    do {
+        buf[n++] = '0' + u % 10;
+        u /= 10;
+    } while(u);
+
+    if(v < 0)
+        *p++ = '-';
+    while(n)
+        *p++ = buf[--n];
+    *p = '\0';
+
+    return p;
+}
+
+/**
+ * Update the display text after receiving a frame.
+ * @param f The frame
+ */
+static void show_frame(const frame_t* f)
+{
+    char line[32];
+    char* p;
+    uint8_t i, row;
+
+    p = line;
+    memcpy(p, "rx ", 3);
+    fmt_num(p + 3, rx_count);
+    display_setLine(1, line);
+
+    memcpy(p, "ovf ", 4);
+    p = fmt_num(p + 4, ring_overflows);
+    memcpy(p, " fifo ", 6);
+    fmt_num(p + 6, fifo_overruns);
+    display_setLine(2, line);
+
+    p = fmt_num(line, f->rssi);
+    memcpy(p, "dBm ", 4);
+    p = fmt_num(p + 4, (int32_t)f->fei * 61);
+    memcpy(p, "Hz", 3);
+    display_setLine(3, line);
+
+    // The packet itself, wrapped over the remaining rows
+    for(row = 4, i = 0; row < DISPLAY_ROWS; row++)
+    {
+        for(p = line; i < f->len && p < line + DISPLAY_COLS; i++)
+            *p++ = (f->data[i] >= ' ' && f->data[i] <= '~') ? f->data[i] : '.';
+        *p = '\0';
+        display_setLine(row, line);
+    }
+}
+
+/**
+ * Read a frame out of the RFM69 if it has one, into the ring.
+ * @returns The frame, or NULL if there wasn't one
+ */
+static const frame_t* radio_service(void)
+{
+    frame_t* f;
+    uint32_t now;
+    uint8_t flags;
+
+    flags = rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2);
+
+    // Writing the flag back clears it along with the FIFO
+    if(flags & RF_IRQFLAGS2_FIFOOVERRUN)
+    {
+        fifo_overruns++;
+        rf69_spiWrite(RFM69_REG_28_IRQ_FLAGS2, RF_IRQFLAGS2_FIFOOVERRUN);
+        return NULL;
+    }
+
+    if(!(flags & RF_IRQFLAGS2_PAYLOADREADY))
+        return NULL;
+    now = timestamp();
+
+    // If the ring is full the frame is still read, to restart the receiver
+    f = ring_claim(&ring);
+    if(!f)
+    {
+        ring_overflows++;
+        f = &discard;
+    }
+
+    if(!rf69_receive(f->data, &f->len))
+        return NULL;
+    f->timestamp = now;
+    f->rssi = rf69_lastRssi();
+    f->fei = rf69_lastFei();
+    rx_count++;
+
+    if(f != &discard)
+        ring_publish(&ring);
+
+    return f;
+}
+
+/*
+ * Radio thread. Highest priority, owns the SPI bus.
+ */
+THD_WORKING_AREA(waRadio, 256);
+THD_FUNCTION(Radio, arg) {
+    (void)arg;
+    const frame_t* f;
+    bool redraw = true;
+
+    // Wait for hardware to start
+    chThdSleepMilliseconds(100);
+
+    // Enable and check the RFM69
+    while(!rf69_init(&SPID1))
+        chThdSleepMilliseconds(1000);
+
+    display_init(&SPID1);
+    display_setLine(0, "UKHASnet monitor");
+
+    dio0_init();
+    last_tick = chVTGetSystemTimeX();
+
+    while(true)
+    {
+        // DIO0 stays high until the FIFO is read, so don't wait if it is
+        chSysLock();
+        if(!palReadPad(GPIOA, GPIOA_RFM_DIO0))
+            chThdSuspendTimeoutS(&radio_trp,
+                    redraw ? 1 : MS2ST(RADIO_POLL_MS));
+        chSysUnlock();
+
+        if((f = radio_service()) != NULL)
+        {
+            show_frame(f);
+
+            chSysLock();
+            chThdResumeI(&uplink_trp, MSG_OK);
+            chSchRescheduleS();
+            chSysUnlock();
+        }
+        else
+        {
+            // Keep the time extension going while nothing is heard
+            timestamp();
+        }
+
+        // At most one row at a time, so the radio is checked in between
+        redraw = display_refresh();
+    }
+}
+
+/*
+ * Uplink thread. Sends everything in the ring to the ESP8266.
+ */
+THD_WORKING_AREA(waUplink, 256);
+THD_FUNCTION(Uplink, arg) {
+    (void)arg;
+    const frame_t* f;
+    uint16_t len;
+
+    uartStart(&UARTD1, &uart_config);
+
+    while(true)
+    {
+        chSysLock();
+        if(!ring_count(&ring))
+            chThdSuspendS(&uplink_trp);
+        chSysUnlock();
+
+        uplink_begin(&batch, ring_overflows, fifo_overruns);
+        while((f = ring_peek(&ring)) != NULL && uplink_add(&batch, f))
+            ring_release(&ring);
+        len = uplink_finish(&batch);
+
+        chSysLock();
+        uartStartSendI(&UARTD1, len, batch.buf);
+        chThdSuspendS(&tx_trp);
+        chSysUnlock();
+    }
+}
+
+/*
+ * Threads static table, one entry per thread. The number of entries must
+ * match NIL_CFG_NUM_THREADS.
+ */
+THD_TABLE_BEGIN
+  THD_TABLE_ENTRY(waRadio, "radio", Radio, NULL)
+  THD_TABLE_ENTRY(waUplink, "uplink", Uplink, NULL)
+THD_TABLE_END
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+    /*
+     * System initializations.
+     * - HAL initialization, this also initializes the configured device drivers
+     *   and performs the board-specific initializations.
+     * - Kernel initialization, the main() function becomes a thread and the
+     *   RTOS is active.
+     */
+    halInit();
+    ring_init(&ring);
+    chSysInit();
+
+    /* This is now the idle thread loop, you may perform here a low priority
+       task but you must never try to sleep or wait in this loop. Note that
+       this tasks runs at the lowest priority level so any instruction added
+       here will be executed after all other tasks have been started.*/
+    while (true) {
+    }
+}
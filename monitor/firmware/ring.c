@@ -0,0 +1,91 @@
+/**
+ * Lock-free single producer, single consumer ring of received frames.
+ * See ring.h.
+ *
+ * The indices run freely and are only masked to index the slots, so the
+ * ring is full when they differ by RING_SIZE and empty when they are equal.
+ * Each index is loaded with acquire ordering by the side that does not own
+ * it and stored with release ordering by the side that does, so a slot's
+ * contents are always visible before the index that hands it over.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ring.h"
+
+#if RING_SIZE & (RING_SIZE - 1)
+#error "RING_SIZE must be a power of two"
+#endif
+
+#define LOAD(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/**
+ * Empty the ring. Must not be called while either side is using it.
+ * @param r The ring
+ */
+void ring_init(ring_t* r)
+{
+    r->head = 0;
+    r->tail = 0;
+}
+
+/**
+ * This is safe to call from either side, but is only a snapshot.
+ * @param r The ring
+ * @returns The number of frames waiting to be consumed
+ */
+uint32_t ring_count(ring_t* r)
+{
+    return LOAD(&r->head) - LOAD(&r->tail);
+}
+
+/**
+ * Get the next free slot to fill in. It is not visible to the consumer
+ * until ring_publish() is called.
+ * @param r The ring
+ * @returns The slot, or NULL if the ring is full
+ */
+frame_t* ring_claim(ring_t* r)
+{
+    uint32_t head = r->head;
+
+    if(head - LOAD(&r->tail) >= RING_SIZE)
+        return NULL;
+
+    return &r->slot[head & (RING_SIZE - 1)];
+}
+
+/**
+ * Hand the slot returned by the last ring_claim() to the consumer.
+ * @param r The ring
+ */
+void ring_publish(ring_t* r)
+{
+    STORE(&r->head, r->head + 1);
+}
+
+/**
+ * Get the oldest frame in the ring without removing it.
+ * @param r The ring
+ * @returns The frame, or NULL if the ring is empty
+ */
+const frame_t* ring_peek(ring_t* r)
+{
+    uint32_t tail = r->tail;
+
+    if(tail == LOAD(&r->head))
+        return NULL;
+
+    return &r->slot[tail & (RING_SIZE - 1)];
+}
+
+/**
+ * Give the slot returned by the last ring_peek() back to the producer.
+ * @param r The ring
+ */
+void ring_release(ring_t* r)
+{
+    STORE(&r->tail, r->tail + 1);
+}
@@ -0,0 +1,53 @@
+/**
+ * Lock-free single producer, single consumer ring of received frames.
+ *
+ * The radio thread claims a slot, reads the frame from the RFM69 straight
+ * into it and publishes it. The uplink thread peeks at the oldest frame,
+ * copies it into a batch and releases it. Each side only ever writes its
+ * own index, so neither needs to lock out the other, and a slow uplink can
+ * never hold up the radio.
+ *
+ * This file has no ChibiOS dependencies so that it can also be built on the
+ * host against the simulator in monitor/host.
+ */
+
+#ifndef __RING_H__
+#define __RING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Number of slots, must be a power of two */
+#define RING_SIZE           16
+
+/* Largest frame payload, the same as RFM69_MAX_MESSAGE_LEN */
+#define FRAME_MAX_LEN       64
+
+typedef struct
+{
+    uint32_t timestamp;         /* ms since boot */
+    int16_t fei;                /* Frequency error in 61.035Hz steps */
+    int8_t rssi;                /* dBm */
+    uint8_t len;
+    uint8_t data[FRAME_MAX_LEN];
+} frame_t;
+
+typedef struct
+{
+    uint32_t head;              /* Next slot to publish, producer only */
+    uint32_t tail;              /* Next slot to release, consumer only */
+    frame_t slot[RING_SIZE];
+} ring_t;
+
+void ring_init(ring_t* r);
+uint32_t ring_count(ring_t* r);
+
+/* Producer side */
+frame_t* ring_claim(ring_t* r);
+void ring_publish(ring_t* r);
+
+/* Consumer side */
+const frame_t* ring_peek(ring_t* r);
+void ring_release(ring_t* r);
+
+#endif /* __RING_H__ */
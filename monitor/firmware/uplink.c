@@ -0,0 +1,79 @@
+/**
+ * Batching of received frames for the ESP8266 uplink.
+ * See uplink.h for the format.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ring.h"
+#include "uplink.h"
+
+static void put16(uint8_t* p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v)
+{
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+/**
+ * Start a new, empty batch.
+ * @param b The batch
+ * @param ovf Running count of frames dropped because the ring was full
+ * @param fifo Running count of RFM69 FIFO overruns
+ */
+void uplink_begin(uplink_batch_t* b, uint16_t ovf, uint16_t fifo)
+{
+    b->buf[0] = UPLINK_SYNC0;
+    b->buf[1] = UPLINK_SYNC1;
+    put16(&b->buf[5], ovf);
+    put16(&b->buf[7], fifo);
+    b->len = UPLINK_HEADER_LEN;
+    b->count = 0;
+}
+
+/**
+ * Append a frame to the batch.
+ * @param b The batch
+ * @param f The frame, which is copied
+ * @returns false if the frame does not fit, in which case the batch is
+ * unchanged
+ */
+bool uplink_add(uplink_batch_t* b, const frame_t* f)
+{
+    uint8_t* p = &b->buf[b->len];
+
+    if(b->len + UPLINK_RECORD_LEN + f->len > UPLINK_BATCH_MAX
+            || b->count == 0xFF)
+        return false;
+
+    p[0] = f->len;
+    p[1] = (uint8_t)f->rssi;
+    put16(&p[2], (uint16_t)f->fei);
+    put32(&p[4], f->timestamp);
+    memcpy(&p[UPLINK_RECORD_LEN], f->data, f->len);
+
+    b->len += UPLINK_RECORD_LEN + f->len;
+    b->count++;
+
+    return true;
+}
+
+/**
+ * Fill in the batch length and frame count, ready to send.
+ * @param b The batch
+ * @returns The number of bytes to send from b->buf
+ */
+uint16_t uplink_finish(uplink_batch_t* b)
+{
+    put16(&b->buf[2], b->len);
+    b->buf[4] = b->count;
+
+    return b->len;
+}
@@ -0,0 +1,60 @@
+/**
+ * Batching of received frames for the ESP8266 uplink.
+ *
+ * Frames are sent over the UART in length-prefixed batches, all multi-byte
+ * fields little endian:
+ *
+ *   Batch header (9 bytes)
+ *     'U' 'K'          Sync bytes
+ *     len    u16       Length of the whole batch including this header
+ *     count  u8        Number of frame records that follow
+ *     ovf    u16       Frames dropped because the ring was full
+ *     fifo   u16       RFM69 FIFO overruns
+ *
+ *   Frame record (8 bytes + payload), repeated count times
+ *     len    u8        Payload length
+ *     rssi   i8        RSSI in dBm
+ *     fei    i16       Frequency error in 61.035Hz steps
+ *     time   u32       Receive time in ms since boot
+ *     data   len bytes The packet as received, e.g. 3aT12.3[AB1]
+ *
+ * The overflow counters are running totals since boot which wrap at 65536,
+ * so the receiving end should look at the difference between batches.
+ *
+ * This file has no ChibiOS dependencies so that it can also be built on the
+ * host against the simulator in monitor/host.
+ */
+
+#ifndef __UPLINK_H__
+#define __UPLINK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ring.h"
+
+#define UPLINK_SYNC0            'U'
+#define UPLINK_SYNC1            'K'
+
+#define UPLINK_HEADER_LEN       9
+#define UPLINK_RECORD_LEN       8
+
+/* Largest batch, which must hold at least one maximum length frame */
+#define UPLINK_BATCH_MAX        256
+
+#if UPLINK_BATCH_MAX < UPLINK_HEADER_LEN + UPLINK_RECORD_LEN + FRAME_MAX_LEN
+#error "UPLINK_BATCH_MAX is too small for a single frame"
+#endif
+
+typedef struct
+{
+    uint8_t buf[UPLINK_BATCH_MAX];
+    uint16_t len;
+    uint8_t count;
+} uplink_batch_t;
+
+void uplink_begin(uplink_batch_t* b, uint16_t ovf, uint16_t fifo);
+bool uplink_add(uplink_batch_t* b, const frame_t* f);
+uint16_t uplink_finish(uplink_batch_t* b);
+
+#endif /* __UPLINK_H__ */
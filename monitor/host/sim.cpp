@@ -0,0 +1,446 @@
+/**
+ * Host simulation of the monitor firmware's receive path.
+ *
+ * Runs the firmware's own ring.c and uplink.c between two threads shaped
+ * like the firmware's radio and uplink threads, with a software stand-in for
+ * the RFM69 and the UART:
+ *
+ *   air      Generates UKHASnet packets with real 2kbps airtimes, either back
+ *            to back (the network's peak rate) or with random gaps. Like the
+ *            RFM69 it holds one packet at a time, and a packet that completes
+ *            while the last is still unread is lost as a FIFO overrun.
+ *   radio    Looks for a packet every --poll-ms, as the firmware does on the
+ *            boards as built, which don't route DIO0, or with --poll-ms 0
+ *            waits for "DIO0" as if it were wired. It reads the packet into
+ *            the ring, and pays for the SPI transfer and a display row
+ *            redraw, as the firmware does.
+ *   uplink   Empties the ring into a batch, waits for it to go out at the
+ *            UART baud rate, and hands the bytes to a parser standing in for
+ *            the ESP8266, which checks every frame arrives once, in order.
+ *
+ * Time runs --speed times faster than real time so a long run at the peak
+ * rate only takes a few seconds. Each packet carries a sequence number so
+ * the parser can account for every loss, which must match the overflow
+ * counters reported in the batch headers. Host scheduling jitter is
+ * multiplied up by --speed too, so the latency figure is pessimistic.
+ *
+ * Usage: monitor-sim [--packets n] [--gap-ms mean] [--baud b] [--speed x]
+ *                    [--poll-ms ms] [--allow-loss]
+ * The exit status is 1 if any frame was lost and --allow-loss is not given.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "../firmware/ring.h"
+#include "../firmware/uplink.h"
+}
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+/* UKHASnet modem: 2kbps, 3 byte preamble, 2 sync, length, CRC16 */
+const double BIT_US = 500.0;
+const int FRAME_OVERHEAD = 3 + 2 + 1 + 2;
+
+/* Firmware costs per frame: FIFO read at 6MHz SPI, plus one display row */
+const double SPI_US = 150.0;
+const double DISPLAY_ROW_US = 250.0;
+
+/* Must match RADIO_POLL_MS in ../firmware/main.c */
+const double RADIO_POLL_MS = 5;
+
+struct Options {
+    unsigned packets = 2000;
+    double gap_ms = 0;
+    unsigned baud = 115200;
+    double speed = 50;
+    double poll_ms = RADIO_POLL_MS;
+    bool allow_loss = false;
+};
+
+Options opt;
+Clock::time_point t0;
+
+/* Sleep for a simulated duration */
+void sim_sleep(double us)
+{
+    std::this_thread::sleep_for(
+            std::chrono::duration<double, std::micro>(us / opt.speed));
+}
+
+/* Simulated time since the start, in ms */
+uint32_t sim_ms()
+{
+    std::chrono::duration<double, std::milli> d = Clock::now() - t0;
+    return (uint32_t)(d.count() * opt.speed);
+}
+
+/**
+ * The RFM69 stand-in. Holds at most one received packet, like the FIFO in
+ * packet mode, and raises "DIO0" while it does.
+ */
+struct Radio {
+    std::mutex m;
+    std::condition_variable dio0;
+    bool ready = false;
+    std::string fifo;
+    int8_t rssi = 0;
+    int16_t fei = 0;
+    unsigned overruns = 0;
+    bool done = false;
+
+    /* A packet has finished arriving off the air */
+    void deliver(const std::string& p, int8_t r, int16_t f)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if(ready)
+        {
+            overruns++;
+            return;
+        }
+        fifo = p;
+        rssi = r;
+        fei = f;
+        ready = true;
+        dio0.notify_one();
+    }
+};
+
+Radio radio;
+ring_t ring;
+
+/* Counters the firmware radio thread keeps */
+std::atomic<uint32_t> ring_overflows(0);
+std::atomic<uint32_t> fifo_overruns(0);
+std::atomic<uint32_t> max_depth(0);
+
+/* Wake-up for the uplink thread, standing in for chThdResumeI() */
+std::mutex uplink_m;
+std::condition_variable uplink_cv;
+std::atomic<bool> radio_done(false);
+
+/**
+ * Generate packets, each taking its real airtime.
+ */
+void air_thread()
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> len(10, FRAME_MAX_LEN);
+    std::uniform_int_distribution<int> rssi(-110, -40);
+    std::uniform_int_distribution<int> fei(-50, 50);
+    std::exponential_distribution<double> gap(
+            opt.gap_ms > 0 ? 1.0 / opt.gap_ms : 1.0);
+    char seq[16];
+
+    for(unsigned i = 0; i < opt.packets; i++)
+    {
+        /* The sequence number goes where a node would put its data */
+        std::snprintf(seq, sizeof(seq), "3aS%08X", i);
+        std::string p(seq);
+        int n = len(rng);
+        p += "[";
+        while((int)p.size() < n - 1)
+            p += (char)('A' + p.size() % 26);
+        p += "]";
+
+        if(opt.gap_ms > 0)
+            sim_sleep(gap(rng) * 1000.0);
+        sim_sleep((FRAME_OVERHEAD + p.size()) * 8 * BIT_US);
+
+        radio.deliver(p, rssi(rng), fei(rng));
+    }
+
+    std::lock_guard<std::mutex> lk(radio.m);
+    radio.done = true;
+    radio.dio0.notify_one();
+}
+
+/**
+ * The firmware's radio thread and radio_service().
+ */
+void radio_thread()
+{
+    frame_t discard;
+    frame_t* f;
+
+    while(true)
+    {
+        std::unique_lock<std::mutex> lk(radio.m);
+        if(opt.poll_ms > 0)
+        {
+            /* No DIO0, so look again every poll period */
+            while(!radio.ready && !radio.done)
+            {
+                lk.unlock();
+                sim_sleep(opt.poll_ms * 1000.0);
+                lk.lock();
+            }
+        }
+        else
+        {
+            radio.dio0.wait(lk, [] { return radio.ready || radio.done; });
+        }
+        if(!radio.ready)
+            break;
+
+        sim_sleep(SPI_US);
+
+        f = ring_claim(&ring);
+        if(!f)
+        {
+            ring_overflows++;
+            f = &discard;
+        }
+
+        f->len = radio.fifo.size();
+        std::memcpy(f->data, radio.fifo.data(), f->len);
+        f->rssi = radio.rssi;
+        f->fei = radio.fei;
+        f->timestamp = sim_ms();
+        radio.ready = false;
+        fifo_overruns = radio.overruns;
+        lk.unlock();
+
+        if(f != &discard)
+        {
+            ring_publish(&ring);
+            max_depth = std::max<uint32_t>(max_depth, ring_count(&ring));
+            std::lock_guard<std::mutex> ulk(uplink_m);
+            uplink_cv.notify_one();
+        }
+
+        /* The firmware redraws a display row before looking again */
+        sim_sleep(DISPLAY_ROW_US);
+    }
+
+    fifo_overruns = radio.overruns;
+    radio_done = true;
+    std::lock_guard<std::mutex> ulk(uplink_m);
+    uplink_cv.notify_one();
+}
+
+/**
+ * The ESP8266 end of the UART. Parses batches out of the byte stream and
+ * checks the frames in them.
+ */
+struct Parser {
+    std::vector<uint8_t> buf;
+    unsigned batches = 0;
+    unsigned frames = 0;
+    unsigned max_batch = 0;
+    unsigned bad = 0;
+    uint32_t next_seq = 0;
+    unsigned missing = 0;
+    uint16_t ovf = 0;
+    uint16_t fifo = 0;
+    uint32_t max_latency = 0;
+
+    static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    static uint32_t get32(const uint8_t* p)
+    {
+        return get16(p) | ((uint32_t)get16(p + 2) << 16);
+    }
+
+    void push(const uint8_t* p, size_t n)
+    {
+        buf.insert(buf.end(), p, p + n);
+
+        while(buf.size() >= UPLINK_HEADER_LEN)
+        {
+            if(buf[0] != UPLINK_SYNC0 || buf[1] != UPLINK_SYNC1)
+            {
+                bad++;
+                buf.erase(buf.begin());
+                continue;
+            }
+
+            uint16_t len = get16(&buf[2]);
+            if(buf.size() < len)
+                return;
+
+            batch(&buf[0], len);
+            buf.erase(buf.begin(), buf.begin() + len);
+        }
+    }
+
+    void batch(const uint8_t* b, uint16_t len)
+    {
+        uint8_t count = b[4];
+        uint16_t pos = UPLINK_HEADER_LEN;
+
+        ovf = get16(&b[5]);
+        fifo = get16(&b[7]);
+        if(count)
+            batches++;
+        max_batch = std::max<unsigned>(max_batch, count);
+
+        for(uint8_t i = 0; i < count; i++)
+        {
+            const uint8_t* r = b + pos;
+            uint8_t n = r[0];
+            uint32_t seq;
+
+            if(pos + UPLINK_RECORD_LEN + n > len)
+            {
+                bad++;
+                return;
+            }
+
+            std::string data((const char*)r + UPLINK_RECORD_LEN, n);
+            if(data.size() < 11
+                    || std::sscanf(data.c_str() + 3, "%8X", &seq) != 1)
+            {
+                bad++;
+            }
+            else
+            {
+                if(seq < next_seq)
+                    bad++;
+                else
+                    missing += seq - next_seq;
+                next_seq = seq + 1;
+            }
+
+            max_latency = std::max(max_latency, sim_ms() - get32(&r[4]));
+            frames++;
+            pos += UPLINK_RECORD_LEN + n;
+        }
+
+        if(pos != len)
+            bad++;
+    }
+};
+
+Parser esp;
+
+/**
+ * The firmware's uplink thread.
+ */
+void uplink_thread()
+{
+    uplink_batch_t batch;
+    const frame_t* f;
+    uint16_t len;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lk(uplink_m);
+            uplink_cv.wait(lk, [] {
+                return ring_count(&ring) || radio_done;
+            });
+            if(!ring_count(&ring))
+                break;
+        }
+
+        uplink_begin(&batch, ring_overflows, fifo_overruns);
+        while((f = ring_peek(&ring)) != NULL && uplink_add(&batch, f))
+            ring_release(&ring);
+        len = uplink_finish(&batch);
+
+        /* 10 bits per byte on the wire */
+        sim_sleep(len * 10 * 1e6 / opt.baud);
+        esp.push(batch.buf, len);
+    }
+
+    /* One last header so the final counters reach the other end */
+    uplink_begin(&batch, ring_overflows, fifo_overruns);
+    len = uplink_finish(&batch);
+    esp.push(batch.buf, len);
+}
+
+void usage()
+{
+    std::fprintf(stderr, "Usage: monitor-sim [--packets n] [--gap-ms mean] "
+            "[--baud b] [--speed x] [--poll-ms ms] [--allow-loss]\n");
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string a(argv[i]);
+        if(a == "--allow-loss")
+            opt.allow_loss = true;
+        else if(i + 1 >= argc)
+            usage();
+        else if(a == "--packets")
+            opt.packets = std::atoi(argv[++i]);
+        else if(a == "--gap-ms")
+            opt.gap_ms = std::atof(argv[++i]);
+        else if(a == "--baud")
+            opt.baud = std::atoi(argv[++i]);
+        else if(a == "--speed")
+            opt.speed = std::atof(argv[++i]);
+        else if(a == "--poll-ms")
+            opt.poll_ms = std::atof(argv[++i]);
+        else
+            usage();
+    }
+
+    ring_init(&ring);
+    t0 = Clock::now();
+
+    std::thread up(uplink_thread);
+    std::thread rx(radio_thread);
+    std::thread air(air_thread);
+    air.join();
+    rx.join();
+    up.join();
+
+    unsigned lost = opt.packets - esp.frames;
+    esp.missing += opt.packets - esp.next_seq;
+
+    std::printf("packets sent       %u (%s, %u baud uplink)\n", opt.packets,
+            opt.gap_ms > 0 ? "random gaps" : "back to back", opt.baud);
+    if(opt.poll_ms > 0)
+        std::printf("radio              polled every %g ms\n", opt.poll_ms);
+    else
+        std::printf("radio              woken by DIO0\n");
+    std::printf("frames delivered   %u\n", esp.frames);
+    std::printf("frames lost        %u\n", lost);
+    std::printf("  fifo overruns    %u (reported %u)\n",
+            radio.overruns, esp.fifo);
+    std::printf("  ring overflows   %u (reported %u)\n",
+            (unsigned)ring_overflows, esp.ovf);
+    std::printf("batches            %u, up to %u frames\n",
+            esp.batches, esp.max_batch);
+    std::printf("max ring depth     %u of %u\n",
+            (unsigned)max_depth, RING_SIZE);
+    std::printf("max latency        %u ms\n", esp.max_latency);
+    std::printf("parse errors       %u\n", esp.bad);
+
+    /* Every missing sequence number must be accounted for by a counter */
+    if(esp.bad || esp.missing != lost
+            || lost != radio.overruns + ring_overflows
+            || esp.fifo != (uint16_t)radio.overruns
+            || esp.ovf != (uint16_t)ring_overflows)
+    {
+        std::printf("FAIL: losses not accounted for\n");
+        return 1;
+    }
+
+    if(lost && !opt.allow_loss)
+    {
+        std::printf("FAIL: frames lost\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * UKHASnet RGB node
+ *
+ * Drives the WS2812B on the RGB node board, with the colour set over the air
+ * by a downlink packet. A packet carrying the message
+ *     :RGB,<NODE_ID>,rrggbb[,ms]
+ * sets the LED to the hex colour rrggbb, fading over ms milliseconds if
+ * given. For example
+ *     3c:RGB,RGB1,ff8000,2000[GW1]
+ *
+ * Fades are interpolated in 8.8 fixed point. The LED is only rewritten when
+ * the gamma corrected value it shows actually changes, and the radio is
+ * polled less often when there is no fade in progress, so in the steady
+ * state the MCU spends almost all of its time in WFI.
+ *
+ * https://ukhas.net
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "nil.h"
+
+#include "RFM69.h"
+#include "ws2812.h"
+
+/* Node configuration options */
+#define NODE_ID         "RGB1"
+
+/* Frame period while fading, and radio poll period when not (ms) */
+#define FRAME_MS        20
+#define IDLE_POLL_MS    100
+
+/* Longest fade we accept, so the step count fits in a uint16_t */
+#define FADE_MAX_MS     60000
+
+/* Colour channels as sent to the LED */
+enum { CH_G, CH_R, CH_B };
+
+/* Current colour in 8.8 fixed point, per channel step, and target */
+static int32_t current[WS2812_BYTES];
+static int32_t step[WS2812_BYTES];
+static uint8_t target[WS2812_BYTES];
+
+/* Frames left in the current fade, zero when not fading */
+static uint16_t fade_frames;
+
+/* The gamma corrected bytes last sent to the LED */
+static uint8_t shown[WS2812_BYTES * WS2812_NUM_LEDS];
+
+static uint8_t rx_buf[RFM69_MAX_MESSAGE_LEN + 1];
+
+/**
+ * Parse two hex digits.
+ * @param s Pointer to the first digit
+ * @returns The value 0-255, or -1 if either character is not a hex digit
+ */
+static int16_t parse_hex_byte(const char* s)
+{
+    int16_t v = 0;
+    uint8_t i;
+    char c;
+
+    for(i = 0; i < 2; i++)
+    {
+        c = s[i];
+        v <<= 4;
+        if(c >= '0' && c <= '9')
+            v |= c - '0';
+        else if(c >= 'a' && c <= 'f')
+            v |= c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F')
+            v |= c - 'A' + 10;
+        else
+            return -1;
+    }
+
+    return v;
+}
+
+/**
+ * Start a fade to a new colour.
+ * @param rgb The new colour, R, G, B
+ * @param ms Fade time, zero to change immediately
+ */
+static void set_target(const uint8_t* rgb, uint16_t ms)
+{
+    uint8_t i;
+
+    target[CH_R] = rgb[0];
+    target[CH_G] = rgb[1];
+    target[CH_B] = rgb[2];
+
+    fade_frames = ms / FRAME_MS;
+    if(fade_frames == 0)
+        fade_frames = 1;
+
+    for(i = 0; i < WS2812_BYTES; i++)
+        step[i] = (((int32_t)target[i] << 8) - current[i]) / fade_frames;
+}
+
+/**
+ * Look for a colour command for this node in a received packet and act on
+ * it. Anything else is ignored.
+ * @param buf The packet, which must be nul terminated
+ */
+static void handle_packet(const char* buf)
+{
+    const char* p;
+    const char* end;
+    uint8_t rgb[3];
+    int16_t v;
+    uint32_t ms = 0;
+    uint8_t i;
+
+    /* The message field runs from ':' up to the path in [] */
+    p = strchr(buf, ':');
+    end = strchr(buf, '[');
+    if(!p || !end || end < p)
+        return;
+
+    if(strncmp(p, ":RGB," NODE_ID ",", sizeof(":RGB," NODE_ID ",") - 1))
+        return;
+    p += sizeof(":RGB," NODE_ID ",") - 1;
+
+    if(end - p < 6)
+        return;
+    for(i = 0; i < 3; i++, p += 2)
+    {
+        if((v = parse_hex_byte(p)) < 0)
+            return;
+        rgb[i] = v;
+    }
+
+    if(*p == ',')
+    {
+        for(p++; p < end && *p >= '0' && *p <= '9'; p++)
+            ms = ms * 10 + (*p - '0');
+        if(ms > FADE_MAX_MS)
+            ms = FADE_MAX_MS;
+    }
+    if(p != end)
+        return;
+
+    set_target(rgb, ms);
+}
+
+/**
+ * Advance the fade by one frame.
+ */
+static void fade_step(void)
+{
+    uint8_t i;
+
+    if(!fade_frames)
+        return;
+
+    /* Land exactly on the target to avoid any rounding error */
+    if(--fade_frames == 0)
+    {
+        for(i = 0; i < WS2812_BYTES; i++)
+            current[i] = (int32_t)target[i] << 8;
+        return;
+    }
+
+    for(i = 0; i < WS2812_BYTES; i++)
+        current[i] += step[i];
+}
+
+/**
+ * Send the current colour to the LED, if it would look any different to
+ * what is already there.
+ */
+static void update_led(void)
+{
+    uint8_t out[WS2812_BYTES * WS2812_NUM_LEDS];
+    uint8_t i;
+
+    for(i = 0; i < sizeof(out); i++)
+        out[i] = ws2812_gamma[(current[i % WS2812_BYTES] + 0x80) >> 8];
+
+    if(!memcmp(out, shown, sizeof(out)))
+        return;
+
+    ws2812_write(out, sizeof(out));
+    memcpy(shown, out, sizeof(out));
+}
+
+/*
+ * Radio and LED thread.
+ */
+THD_WORKING_AREA(waThread1, 256);
+THD_FUNCTION(Thread1, arg) {
+    (void)arg;
+    uint8_t len;
+
+    // Wait for hardware to start
+    chThdSleepMilliseconds(100);
+
+    // Blank the LED, it powers up in an unknown state
+    ws2812_write(shown, sizeof(shown));
+
+    // Enable and check the RFM69
+    while(!rf69_init(&SPID1))
+        chThdSleepMilliseconds(1000);
+
+    while(true)
+    {
+        if(rf69_receive(rx_buf, &len))
+        {
+            rx_buf[len] = '\0';
+            handle_packet((const char*)rx_buf);
+        }
+
+        fade_step();
+        update_led();
+
+        // The LEDs latch during this, which is far longer than needed
+        chThdSleepMilliseconds(fade_frames ? FRAME_MS : IDLE_POLL_MS);
+    }
+}
+
+/*
+ * Threads static table, one entry per thread. The number of entries must
+ * match NIL_CFG_NUM_THREADS.
+ */
+THD_TABLE_BEGIN
+  THD_TABLE_ENTRY(waThread1, "thd1", Thread1, NULL)
+THD_TABLE_END
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+    /*
+     * System initializations.
+     * - HAL initialization, this also initializes the configured device drivers
+     *   and performs the board-specific initializations.
+     * - Kernel initialization, the main() function becomes a thread and the
+     *   RTOS is active.
+     */
+    halInit();
+    chSysInit();
+
+    /* This is now the idle thread loop. Sleep the core until the next
+       interrupt, which will be the system tick that wakes the thread
+       above. */
+    while (true) {
+        __WFI();
+    }
+}
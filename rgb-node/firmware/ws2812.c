@@ -0,0 +1,126 @@
+/**
+ * Bit-banged driver for WS2812B RGB LEDs.
+ * See ws2812.h.
+ */
+
+#include "hal.h"
+#include "nil.h"
+
+#include "ws2812.h"
+
+/* Bitstream timings from the WS2812B datasheet, in ns. A '0' is a short
+ * high pulse and a '1' a long one, each bit lasting TBIT overall. */
+#define WS2812_T0H          400
+#define WS2812_T1H          800
+#define WS2812_TBIT         1250
+
+/* Convert ns to the nearest whole number of core clock cycles */
+#define WS2812_CYCLES(ns) \
+    ((((ns) * (STM32_SYSCLK / 1000000U)) + 500U) / 1000U)
+
+/*
+ * Padding nops between the stores in each bit, with the cycles used by the
+ * other instructions taken off. On the Cortex-M0 a str takes 2 cycles, the
+ * lsls/sbcs/ands that pick out the next bit take 1 each, and the loop
+ * overhead after the last bit of each byte (subs, taken bne, ldrb, adds,
+ * lsls) takes 8.
+ */
+#define WS2812_PAD_T0H      (WS2812_CYCLES(WS2812_T0H) - 5)
+#define WS2812_PAD_T1H      (WS2812_CYCLES(WS2812_T1H) - \
+                                WS2812_CYCLES(WS2812_T0H) - 2)
+#define WS2812_PAD_LOW      (WS2812_CYCLES(WS2812_TBIT) - \
+                                WS2812_CYCLES(WS2812_T1H) - 2)
+#define WS2812_PAD_LAST     (WS2812_PAD_LOW - 8)
+
+/* This relies on running from flash with no wait states */
+#if STM32_SYSCLK > 24000000
+#error "WS2812 timing assumes SYSCLK <= 24MHz (zero flash wait states)"
+#endif
+
+/* The cycle counts are unsigned in the preprocessor, so compare them
+ * rather than testing the pads for < 0 */
+#if WS2812_CYCLES(WS2812_T0H) < 5 || \
+        WS2812_CYCLES(WS2812_T1H) < WS2812_CYCLES(WS2812_T0H) + 2 || \
+        WS2812_CYCLES(WS2812_TBIT) < WS2812_CYCLES(WS2812_T1H) + 2 + 8
+#error "SYSCLK too slow to generate the WS2812 bitstream"
+#endif
+
+/*
+ * One bit, MSB first out of the top of 'byte'. The line is set high, then
+ * cleared at T0H if the bit is a '0' and at T1H regardless. Writing the
+ * 'low' mask to BRR is a no-op for a '1', so there is no branch in the bit
+ * and every bit takes the same number of cycles.
+ */
+#define WS2812_BIT(pad) \
+    "str  %[mask], [%[port], #0x18]     \n\t" \
+    "lsls %[byte], %[byte], #1          \n\t" \
+    "sbcs %[low], %[low]                \n\t" \
+    "ands %[low], %[mask]               \n\t" \
+    ".rept %c[t0h]                      \n\t" \
+    "nop                                \n\t" \
+    ".endr                              \n\t" \
+    "str  %[low], [%[port], #0x28]      \n\t" \
+    ".rept %c[t1h]                      \n\t" \
+    "nop                                \n\t" \
+    ".endr                              \n\t" \
+    "str  %[mask], [%[port], #0x28]     \n\t" \
+    ".rept %c[" pad "]                  \n\t" \
+    "nop                                \n\t" \
+    ".endr                              \n\t"
+
+/**
+ * Gamma correction table, gamma = 2.8. Being const this lives in flash.
+ */
+const uint8_t ws2812_gamma[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
+      5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+     10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
+     17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+     25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+     37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
+     51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
+     69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
+     90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
+    115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
+    144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
+    177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
+    215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255
+};
+
+/**
+ * Send a frame to the LED chain. The caller must leave the line idle for
+ * WS2812_LATCH_US before the LEDs will show it, and before the next frame.
+ * @param grb The colour bytes, three per LED in G, R, B order
+ * @param len The number of bytes to send, must be nonzero
+ */
+void ws2812_write(const uint8_t* grb, uint16_t len)
+{
+    uint32_t mask = 1U << GPIOA_LED_DO;
+    uint32_t byte, low = 0;
+    uint32_t n = len;
+
+    chSysLock();
+
+    __asm__ volatile(
+        ".syntax unified                    \n\t"
+        "1:                                 \n\t"
+        "ldrb %[byte], [%[ptr]]             \n\t"
+        "adds %[ptr], #1                    \n\t"
+        "lsls %[byte], %[byte], #24         \n\t"
+        WS2812_BIT("tlow") WS2812_BIT("tlow") WS2812_BIT("tlow")
+        WS2812_BIT("tlow") WS2812_BIT("tlow") WS2812_BIT("tlow")
+        WS2812_BIT("tlow") WS2812_BIT("tlast")
+        "subs %[n], #1                      \n\t"
+        "bne  1b                            \n\t"
+        : [ptr] "+l" (grb), [n] "+l" (n),
+          [byte] "=&l" (byte), [low] "+l" (low)
+        : [port] "l" (GPIOA), [mask] "l" (mask),
+          [t0h] "i" (WS2812_PAD_T0H), [t1h] "i" (WS2812_PAD_T1H),
+          [tlow] "i" (WS2812_PAD_LOW), [tlast] "i" (WS2812_PAD_LAST)
+        : "cc", "memory");
+
+    chSysUnlock();
+}
@@ -0,0 +1,29 @@
+/**
+ * Bit-banged driver for WS2812B RGB LEDs.
+ *
+ * The 800kHz bitstream is generated by cycle counted inline assembly, with
+ * the delays between edges worked out at compile time from STM32_SYSCLK.
+ * There is no DMA or timer involved, so interrupts are masked while a frame
+ * is being sent.
+ */
+
+#ifndef __WS2812_H__
+#define __WS2812_H__
+
+#include <stdint.h>
+
+/* Number of LEDs on the chain, the RGB node has just the one */
+#define WS2812_NUM_LEDS     1
+
+/* Bytes per LED, sent in G, R, B order */
+#define WS2812_BYTES        3
+
+/* The data line must idle low for this long before the LEDs latch */
+#define WS2812_LATCH_US     300
+
+/* Perceptual brightness to PWM duty cycle */
+extern const uint8_t ws2812_gamma[256];
+
+void ws2812_write(const uint8_t* grb, uint16_t len);
+
+#endif /* __WS2812_H__ */
@@ -0,0 +1,247 @@
+// RFM69.c
+//
+// Ported to Arduino 2014 James Coxon
+//
+// Ported to bare metal AVR 2014 Jon Sowman
+//
+// Cut down for the ATtiny13 WH1080 bridge, which has too little RAM to hold
+// either a config table or a packet buffer, so both are streamed instead.
+//
+// Copyright (C) 2014 Phil Crump
+// Copyright (C) 2014 Jon Sowman <jon@jonsowman.com>
+//
+// Based on RF22 Copyright (C) 2011 Mike McCauley ported to mbed by Karl Zweimueller
+// Based on RFM69 LowPowerLabs (https://github.com/LowPowerLab/RFM69/)
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+
+#include "RFM69.h"
+
+/**
+ * Assert SS on the RFM69 for communications.
+ */
+#define RFM_SS_ASSERT() do { SPI_PORT &= ~(SPI_SS); } while(0)
+
+/**
+ * Release SS on the RFM69 to abort or terminate comms
+ */
+#define RFM_SS_DEASSERT() do { SPI_PORT |= (SPI_SS); } while(0)
+
+/** Track the current mode of the radio */
+static uint8_t _mode;
+
+/** Mode to return to once a transmission has finished */
+static uint8_t _oldMode;
+
+/**
+ * Initialise the SPI lines and check that an RFM69 is present. The caller
+ * then loads whichever profile it wants from RFM69Config.h, which is only
+ * included in one translation unit so the tables are not duplicated in flash.
+ * @returns 0 on failure, nonzero on success
+ */
+bool rf69_init(void)
+{
+    /* Set up the SPI IO as appropriate */
+    SPI_DDR |= SPI_SS | SPI_MOSI | SPI_SCK;
+    SPI_DDR &= ~SPI_MISO;
+
+    /* Set SS high */
+    SPI_PORT |= SPI_SS;
+
+    /* In mode 0, SCK idles low */
+    SPI_PORT &= ~SPI_SCK;
+
+    _delay_ms(10);
+
+    // Zero version number, RFM probably not connected/functioning
+    if(rf69_spiRead(RFM69_REG_10_VERSION) != 0x24)
+        return false;
+
+    return true;
+}
+
+/**
+ * Write a {register, value} table held in flash into the RFM69. The table is
+ * terminated by a register address of 255.
+ * @param config The table to load, which must be in PROGMEM
+ */
+void rf69_loadConfig(const uint8_t (*config)[2])
+{
+    uint8_t reg;
+
+    while((reg = pgm_read_byte(&config[0][0])) != 255)
+    {
+        rf69_spiWrite(reg, pgm_read_byte(&config[0][1]));
+        config++;
+    }
+}
+
+/**
+ * Send and receive a single byte via a bitbang method.
+ * @warning This doesn't manage SS, to allow for burst read/writing
+ * @note Higher level functions should manage SS.
+ * @param out The byte to be sent synchronously
+ * @returns The byte received during the send transaction.
+ */
+uint8_t spi_bb_xfer(const uint8_t out)
+{
+    uint8_t data = 0;
+
+    for(int8_t i = 7; i >= 0; i--)
+    {
+        if((out >> i) & 0x01)
+            SPI_PORT |= SPI_MOSI;
+        else
+            SPI_PORT &= ~SPI_MOSI;
+        // Clock high
+        SPI_PORT |= SPI_SCK;
+        _delay_us(1);
+        // Read MISO
+        if(SPI_INPORT & SPI_MISO)
+            data |= _BV(i);
+        // Drop clock
+        SPI_PORT &= ~SPI_SCK;
+        _delay_us(1);
+    }
+
+    return data;
+}
+
+/**
+ * Read a single byte from a register in the RFM69. Transmit the (one byte)
+ * address of the register to be read, then read the (one byte) response.
+ * @param reg The register address to be read
+ * @returns The value of the register
+ */
+uint8_t rf69_spiRead(const uint8_t reg)
+{
+    uint8_t data;
+
+    RFM_SS_ASSERT();
+
+    spi_bb_xfer(reg);
+    data = spi_bb_xfer(0xFF); // send dummy to get data back
+
+    RFM_SS_DEASSERT();
+
+    return data;
+}
+
+/**
+ * Write a single byte to a register in the RFM69. Transmit the register
+ * address (one byte) with the write mask RFM_SPI_WRITE_MASK on, and then the
+ * value of the register to be written.
+ * @param reg The address of the register to write
+ * @param val The value for the address
+ */
+void rf69_spiWrite(const uint8_t reg, const uint8_t val)
+{
+    RFM_SS_ASSERT();
+
+    /* Transmit the reg address */
+    spi_bb_xfer(reg | RFM69_SPI_WRITE_MASK);
+
+    /* Transmit the value for this address */
+    spi_bb_xfer(val);
+
+    RFM_SS_DEASSERT();
+}
+
+/**
+ * Open a FIFO write burst for a packet of the given length. The caller then
+ * clocks out exactly len bytes with spi_bb_xfer() and closes the burst with
+ * rf69_fifoWriteEnd(), so the packet never has to exist in RAM.
+ * @param len The number of payload bytes that will follow
+ */
+void rf69_fifoWriteBegin(uint8_t len)
+{
+    RFM_SS_ASSERT();
+
+    // Send the start address with the write mask on
+    spi_bb_xfer(RFM69_REG_00_FIFO | RFM69_SPI_WRITE_MASK);
+
+    // First byte is packet length
+    spi_bb_xfer(len);
+}
+
+/**
+ * Close a FIFO write burst opened with rf69_fifoWriteBegin().
+ */
+void rf69_fifoWriteEnd(void)
+{
+    RFM_SS_DEASSERT();
+}
+
+/**
+ * Change the RFM69 operating mode to a new one.
+ * @param newMode The value representing the new mode (see datasheet for
+ * further information).
+ */
+void rf69_setMode(const uint8_t newMode)
+{
+    rf69_spiWrite(RFM69_REG_01_OPMODE, newMode);
+    _mode = newMode;
+}
+
+/**
+ * Start the transmitter and wait for the PA to ramp. The payload is then
+ * streamed in with rf69_fifoWriteBegin()/rf69_fifoWriteEnd(), which starts
+ * the transmission, and rf69_txEnd() waits for it to finish.
+ * @param power The transmit power to be used in dBm (2-13 on this board)
+ * @returns false if the power level is out of range
+ */
+bool rf69_txBegin(uint8_t power)
+{
+    uint8_t timeout;
+
+    // Only the PA1 path is supported, the bridge runs from a small regulator
+    if(power < 2 || power > 13)
+        return false;
+
+    _oldMode = _mode;
+
+    // Start Transmitter
+    rf69_setMode(RFM69_MODE_TX);
+
+    // Set PA Level
+    rf69_spiWrite(RFM69_REG_11_PA_LEVEL,
+            RF_PALEVEL_PA0_OFF | RF_PALEVEL_PA1_ON | RF_PALEVEL_PA2_OFF | (power + 18));
+
+    // Wait for PA ramp-up
+    timeout = 255;
+    while(!(rf69_spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_TXREADY)
+            && timeout--)
+        _delay_ms(1);
+
+    return true;
+}
+
+/**
+ * Wait for the packet loaded after rf69_txBegin() to leave the radio, then
+ * return to the mode we were in beforehand.
+ */
+void rf69_txEnd(void)
+{
+    uint8_t timeout = 255;
+
+    while(!(rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2) & RF_IRQFLAGS2_PACKETSENT)
+            && timeout--)
+        _delay_ms(5);
+
+    // Return Transceiver to original mode
+    rf69_setMode(_oldMode);
+}
+
+/**
+ * Clear the FIFO in the RFM69. We do this by entering STBY mode and then
+ * returing to RX mode.
+ * @warning Must only be called in RX Mode
+ * @note Apparently this works... found in HopeRF demo code
+ */
+void rf69_clearFifo(void)
+{
+    rf69_setMode(RFM69_MODE_STDBY);
+    rf69_setMode(RFM69_MODE_RX);
+}
@@ -0,0 +1,91 @@
+#ifndef RFM69Config_h
+#define RFM69Config_h
+
+#include <avr/pgmspace.h>
+
+#include "RFM69.h"
+
+/**
+ * UKHASnet FSK profile, as used by the fc-node firmware. Every register that
+ * CONFIG_OOK touches is written here too, except the OOK demodulator's
+ * (0x1B to 0x1D), which the radio ignores in FSK, and SYNCVALUE3 (0x31),
+ * which it ignores with a 2 byte sync word. So loading either table leaves
+ * the radio in a known state regardless of which one was loaded before.
+ */
+PROGMEM static const uint8_t CONFIG_FSK[][2] =
+{
+    { RFM69_REG_01_OPMODE,      RF_OPMODE_SEQUENCER_ON | RF_OPMODE_LISTEN_OFF | RFM69_MODE_STDBY },
+    { RFM69_REG_02_DATA_MODUL,  RF_DATAMODUL_DATAMODE_PACKET | RF_DATAMODUL_MODULATIONTYPE_FSK | RF_DATAMODUL_MODULATIONSHAPING_00 },
+
+    { RFM69_REG_03_BITRATE_MSB, 0x3E}, // 2000 bps
+    { RFM69_REG_04_BITRATE_LSB, 0x80},
+
+    { RFM69_REG_05_FDEV_MSB,    0x00}, // 12000 hz (24000 hz shift)
+    { RFM69_REG_06_FDEV_LSB,    0xC5},
+
+    { RFM69_REG_07_FRF_MSB,     0xD9 }, // 869.5 MHz
+    { RFM69_REG_08_FRF_MID,     0x60 },
+    { RFM69_REG_09_FRF_LSB,     0x12 },
+
+    { RFM69_REG_13_OCP,         RF_OCP_ON | RF_OCP_TRIM_95 },
+    { RFM69_REG_18_LNA,         RF_LNA_ZIN_50 },
+    { RFM69_REG_19_RX_BW,       RF_RXBW_DCCFREQ_010 | RF_RXBW_MANT_16 | RF_RXBW_EXP_2}, // Rx Bandwidth: 128KHz
+    { RFM69_REG_1E_AFC_FEI,     RF_AFCFEI_AFCAUTO_ON | RF_AFCFEI_AFCAUTOCLEAR_ON },
+    { RFM69_REG_26_DIO_MAPPING2, RF_DIOMAPPING2_CLKOUT_OFF }, // Switch off Clkout
+
+    { RFM69_REG_2E_SYNC_CONFIG, RF_SYNC_ON | RF_SYNC_FIFOFILL_AUTO | RF_SYNC_SIZE_2 | RF_SYNC_TOL_0 },
+    { RFM69_REG_2F_SYNCVALUE1, 0x2D },
+    { RFM69_REG_30_SYNCVALUE2, 0xAA },
+    { RFM69_REG_37_PACKET_CONFIG1, RF_PACKET1_FORMAT_VARIABLE | RF_PACKET1_DCFREE_OFF | RF_PACKET1_CRC_ON | RF_PACKET1_CRCAUTOCLEAR_ON | RF_PACKET1_ADRSFILTERING_OFF },
+    { RFM69_REG_38_PAYLOAD_LENGTH, RFM69_FIFO_SIZE },
+    { RFM69_REG_3C_FIFO_THRESHOLD, RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY | 0x05 }, //TX on FIFO not empty
+    { RFM69_REG_3D_PACKET_CONFIG2, RF_PACKET2_RXRESTARTDELAY_2BITS | RF_PACKET2_AUTORXRESTART_ON | RF_PACKET2_AES_OFF },
+    { RFM69_REG_6F_TEST_DAGC, RF_DAGC_IMPROVED_LOWBETA0 },
+    {255, 0}
+};
+
+/**
+ * WH1080 OOK receive profile.
+ *
+ * The station sends pulse width modulated bits: a '1' is ~500us of carrier,
+ * a '0' is ~1500us, and each is followed by ~1000us of silence. DIO2 is not
+ * wired to the ATtiny13 on this board, so rather than use continuous mode we
+ * oversample the envelope in packet mode at 4 kbps (250us chips) and pull
+ * the chips out of the FIFO. A '1' is then 110000 and the 0xFF preamble is
+ * that pattern repeated, which the sync word matches on. Unlimited length
+ * mode keeps the FIFO filling until we restart the receiver ourselves.
+ */
+PROGMEM static const uint8_t CONFIG_OOK[][2] =
+{
+    { RFM69_REG_01_OPMODE,      RF_OPMODE_SEQUENCER_ON | RF_OPMODE_LISTEN_OFF | RFM69_MODE_STDBY },
+    { RFM69_REG_02_DATA_MODUL,  RF_DATAMODUL_DATAMODE_PACKET | RF_DATAMODUL_MODULATIONTYPE_OOK | RF_DATAMODUL_MODULATIONSHAPING_00 },
+
+    { RFM69_REG_03_BITRATE_MSB, 0x1F}, // 4000 bps chip rate
+    { RFM69_REG_04_BITRATE_LSB, 0x40},
+
+    { RFM69_REG_07_FRF_MSB,     0xD9 }, // 868.3 MHz
+    { RFM69_REG_08_FRF_MID,     0x13 },
+    { RFM69_REG_09_FRF_LSB,     0x33 },
+
+    { RFM69_REG_13_OCP,         RF_OCP_ON | RF_OCP_TRIM_95 },
+    { RFM69_REG_18_LNA,         RF_LNA_ZIN_50 },
+    { RFM69_REG_19_RX_BW,       RF_RXBW_DCCFREQ_010 | RF_RXBW_MANT_24 | RF_RXBW_EXP_1}, // Rx Bandwidth: 83KHz (OOK)
+    { RFM69_REG_1B_OOK_PEAK,    RF_OOKPEAK_THRESHTYPE_PEAK | RF_OOKPEAK_PEAKTHRESHSTEP_000 | RF_OOKPEAK_PEAKTHRESHDEC_000 },
+    { RFM69_REG_1C_OOK_AVG,     RF_OOKAVG_AVERAGETHRESHFILT_10 },
+    { RFM69_REG_1D_OOF_FIX,     RF_OOKFIX_FIXEDTHRESH_VALUE },
+    { RFM69_REG_1E_AFC_FEI,     RF_AFCFEI_AFCAUTO_OFF | RF_AFCFEI_AFCAUTOCLEAR_OFF },
+    { RFM69_REG_26_DIO_MAPPING2, RF_DIOMAPPING2_CLKOUT_OFF },
+
+    /* 24 chips of preamble: 110000 110000 110000 110000 */
+    { RFM69_REG_2E_SYNC_CONFIG, RF_SYNC_ON | RF_SYNC_FIFOFILL_AUTO | RF_SYNC_SIZE_3 | RF_SYNC_TOL_2 },
+    { RFM69_REG_2F_SYNCVALUE1, 0xC3 },
+    { RFM69_REG_30_SYNCVALUE2, 0x0C },
+    { RFM69_REG_31_SYNCVALUE3, 0x30 },
+    { RFM69_REG_37_PACKET_CONFIG1, RF_PACKET1_FORMAT_FIXED | RF_PACKET1_DCFREE_OFF | RF_PACKET1_CRC_OFF | RF_PACKET1_CRCAUTOCLEAR_OFF | RF_PACKET1_ADRSFILTERING_OFF },
+    { RFM69_REG_38_PAYLOAD_LENGTH, 0 }, // Unlimited length
+    { RFM69_REG_3D_PACKET_CONFIG2, RF_PACKET2_RXRESTARTDELAY_2BITS | RF_PACKET2_AUTORXRESTART_OFF | RF_PACKET2_AES_OFF },
+    { RFM69_REG_6F_TEST_DAGC, RF_DAGC_NORMAL },
+    {255, 0}
+};
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * UKHASnet WH1080 bridge
+ *
+ * Listens for Fine Offset WH1080 weather station broadcasts on 868.3MHz
+ * using the RFM69 in OOK mode, then retunes it to the UKHASnet FSK profile
+ * and repeats the readings as a UKHASnet packet.
+ *
+ * The ATtiny13 has 1K of flash and 64 bytes of RAM, so neither the received
+ * bitstream nor the outgoing packet is ever buffered. Chips are sliced into
+ * bits straight out of the RFM69 FIFO (see wh1080.c) and the packet text is
+ * generated twice, once to count its length and once straight into the FIFO.
+ * All conversions are integer only.
+ *
+ * https://ukhas.net
+ */
+
+#include <stdbool.h>
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+
+#include "RFM69.h"
+#include "RFM69Config.h"
+
+#include "wh1080.h"
+
+/* Node configuration options */
+#define NODE_ID         "WH1"
+#define HOPS            "2"
+#define TX_POWER_DBM    10
+
+/* Uncomment to only repeat one station, in case a neighbour's is in range */
+/* #define STATION_ID      0x5A */
+
+/* Starting sequence ID */
+static char seqid = 'a';
+
+/* Number of bytes emitted while generating a packet */
+static uint8_t emitted;
+
+/* When true, emit() only counts the bytes rather than sending them */
+static bool counting;
+
+static const uint16_t decades[] PROGMEM = { 10000, 1000, 100, 10, 1 };
+
+static void receive_frame(void);
+static void send_packet(void);
+
+/* Main loop */
+int main(void)
+{
+    /* Enable and check the RFM69 */
+    while(!rf69_init());
+
+    while(1)
+    {
+        receive_frame();
+
+#ifdef STATION_ID
+        if((uint8_t)((wh1080_frame[0] << 4) | (wh1080_frame[1] >> 4))
+                != STATION_ID)
+            continue;
+#endif
+
+        send_packet();
+
+        /* Increase the sequence ID for the next time we enter here */
+        if(seqid == 'z')
+            seqid = 'b';
+        else
+            seqid++;
+    }
+
+    return 0;
+}
+
+/**
+ * Tune to the WH1080 and block until a frame with a good CRC is in
+ * wh1080_frame.
+ */
+static void receive_frame(void)
+{
+    int8_t r;
+
+    rf69_loadConfig(CONFIG_OOK);
+    rf69_setMode(RFM69_MODE_RX);
+    wh1080_reset();
+
+    while(1)
+    {
+        /* Chips arrive every 2ms per byte, poll for the next one */
+        while(!(rf69_spiRead(RFM69_REG_28_IRQ_FLAGS2)
+                    & RF_IRQFLAGS2_FIFONOTEMPTY));
+
+        r = wh1080_chips(rf69_spiRead(RFM69_REG_00_FIFO));
+        if(r == WH1080_DONE)
+            break;
+
+        if(r == WH1080_ERROR)
+        {
+            /* Not a frame after all, go back to looking for a preamble */
+            rf69_clearFifo();
+            wh1080_reset();
+        }
+    }
+
+    rf69_setMode(RFM69_MODE_STDBY);
+}
+
+/**
+ * Count or transmit a single packet character.
+ */
+static void emit(const char c)
+{
+    if(!counting)
+        spi_bb_xfer(c);
+    emitted++;
+}
+
+/**
+ * Emit an unsigned value in decimal.
+ * @param v The value to emit
+ * @param frac If nonzero, the last digit is emitted after a decimal point
+ */
+static void emit_num(uint16_t v, const uint8_t frac)
+{
+    uint8_t i;
+    uint16_t d;
+    char c;
+    bool lead = true;
+
+    for(i = 0; i < 5; i++)
+    {
+        d = pgm_read_word(&decades[i]);
+        for(c = '0'; v >= d; c++)
+            v -= d;
+
+        /* Skip leading zeros, but keep the units digit */
+        if(lead && c == '0' && i < (frac ? 3 : 4))
+            continue;
+        lead = false;
+
+        if(frac && i == 4)
+            emit('.');
+        emit(c);
+    }
+}
+
+/**
+ * Emit the packet for the frame in wh1080_frame. A packet looks like
+     <HOPS><SEQID>Tyy.yHhhWs,dXg,rrr.r[<NODEID>]
+ * where:
+ *   Tyy.y is the temperature in decimal degrees
+ *   Hhh is the relative humidity in %
+ *   Ws,d is the average wind speed in mph and its bearing in degrees
+ *   Xg,rrr.r is a custom field of gust speed in mph and the rain counter
+ *   in mm
+ */
+static void emit_packet(void)
+{
+    const uint8_t *f = wh1080_frame;
+    int16_t t;
+    uint8_t i;
+
+    emitted = 0;
+
+    /* Number of hops */
+    emit(HOPS[0]);
+
+    /* Add sequence ID */
+    emit(seqid);
+
+    /* Temperature is offset by 40.0C */
+    emit('T');
+    t = (int16_t)(((f[1] & 0x0F) << 8) | f[2]) - 400;
+    if(t < 0)
+    {
+        emit('-');
+        t = -t;
+    }
+    emit_num(t, 1);
+
+    emit('H');
+    emit_num(f[3], 0);
+
+    /* 0.34m/s per step is 0.761mph, or 195/256 */
+    emit('W');
+    emit_num(((uint16_t)f[4] * 195 + 128) >> 8, 0);
+    emit(',');
+    emit_num(((f[8] & 0x0F) * 45) >> 1, 0);
+
+    /* Gust speed as above, then rain at 0.3mm per bucket tip */
+    emit('X');
+    emit_num(((uint16_t)f[5] * 195 + 128) >> 8, 0);
+    emit(',');
+    emit_num((((f[6] & 0x0F) << 8) | f[7]) * 3, 1);
+
+    /* Add node ID in [] */
+    emit('[');
+    for(i = 0; i < sizeof(NODE_ID) - 1; i++)
+        emit(NODE_ID[i]);
+    emit(']');
+}
+
+/**
+ * Retune to the UKHASnet profile and send the last received frame.
+ */
+static void send_packet(void)
+{
+    uint8_t len;
+
+    rf69_loadConfig(CONFIG_FSK);
+
+    /* Dry run to find the length, which has to go into the FIFO first */
+    counting = true;
+    emit_packet();
+    len = emitted;
+
+    if(!rf69_txBegin(TX_POWER_DBM))
+        return;
+
+    counting = false;
+    rf69_fifoWriteBegin(len);
+    emit_packet();
+    rf69_fifoWriteEnd();
+
+    rf69_txEnd();
+}
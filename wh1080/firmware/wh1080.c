@@ -0,0 +1,117 @@
+/**
+ * Streaming decoder for Fine Offset WH1080 weather station frames.
+ * See wh1080.h for the frame format.
+ */
+
+#include <stdint.h>
+
+#include "wh1080.h"
+
+/* nbits value while we are still clocking through the preamble */
+#define HUNTING 0xFF
+
+uint8_t wh1080_frame[WH1080_FRAME_LEN];
+
+/* Length of the current run of identical chips, and their level */
+static uint8_t run;
+static uint8_t level;
+
+/* Number of frame bits received so far, or HUNTING */
+static uint8_t nbits;
+
+/* Running CRC over every bit received, which is zero for a valid frame */
+static uint8_t crc;
+
+/**
+ * Forget any partially received frame. Call this whenever the receiver is
+ * restarted, since the next chip will be the one following a sync match.
+ */
+void wh1080_reset(void)
+{
+    run = 0;
+    level = 0;
+    nbits = HUNTING;
+    crc = 0;
+}
+
+/**
+ * Add a single bit to the frame and the CRC.
+ * @param bit The bit value, 0 or 1
+ * @returns WH1080_DONE once all 80 bits are in and the CRC checks out,
+ * WH1080_ERROR if the CRC or message type is wrong, otherwise WH1080_MORE
+ */
+static int8_t wh1080_bit(uint8_t bit)
+{
+    uint8_t i;
+
+    if(nbits == HUNTING)
+    {
+        /* The preamble is all ones and the type nibble starts 10, so the
+         * first zero tells us the one before it was the first frame bit */
+        if(bit)
+            return WH1080_MORE;
+        nbits = 0;
+        wh1080_bit(1);
+    }
+
+    i = nbits >> 3;
+    wh1080_frame[i] = (wh1080_frame[i] << 1) | bit;
+
+    /* CRC-8 poly 0x31, MSB first. Running the received CRC byte through
+     * as well leaves zero in the register if the frame is intact. */
+    if(((crc >> 7) ^ bit) & 0x01)
+        crc = (crc << 1) ^ 0x31;
+    else
+        crc <<= 1;
+
+    if(++nbits < WH1080_FRAME_LEN * 8)
+        return WH1080_MORE;
+
+    if(crc || (wh1080_frame[0] >> 4) != WH1080_TYPE_WEATHER)
+        return WH1080_ERROR;
+
+    return WH1080_DONE;
+}
+
+/**
+ * Slice eight chips from the OOK demodulator into frame bits.
+ * @param chips Eight chips, oldest in the MSB, as read from the RFM69 FIFO
+ * @returns WH1080_DONE when wh1080_frame holds a valid frame, WH1080_ERROR
+ * if the chips cannot be part of a frame and the receiver should be
+ * restarted, otherwise WH1080_MORE
+ */
+int8_t wh1080_chips(uint8_t chips)
+{
+    uint8_t i;
+    int8_t r;
+
+    for(i = 0; i < 8; i++, chips <<= 1)
+    {
+        if(((chips >> 7) & 0x01) == level)
+        {
+            /* Same level, check the pulse or gap isn't overlong */
+            run++;
+            if(run > (level ? WH1080_LONG_MAX : WH1080_GAP_MAX))
+                return WH1080_ERROR;
+            continue;
+        }
+
+        if(level)
+        {
+            /* Falling edge, the pulse width gives us the bit */
+            r = wh1080_bit(run <= WH1080_SHORT_MAX);
+            if(r != WH1080_MORE)
+                return r;
+        }
+        else if(run < WH1080_GAP_MIN && nbits != HUNTING)
+        {
+            /* Rising edge after a gap too short to be real */
+            return WH1080_ERROR;
+        }
+
+        level ^= 0x01;
+        run = 1;
+    }
+
+    return WH1080_MORE;
+}
@@ -0,0 +1,53 @@
+/**
+ * Streaming decoder for Fine Offset WH1080 weather station frames.
+ *
+ * Chips sampled from the RFM69 OOK demodulator are fed in a byte at a time
+ * and sliced into bits as they arrive, so nothing but the 10 byte frame is
+ * ever held in RAM. The CRC is also run bit by bit as the frame fills.
+ *
+ * Frame layout (nibbles):
+ *   AI IT TT HH SS GG ?R RR BD CC
+ *   A: message type, 0xA for weather data
+ *   I: station ID
+ *   T: temperature, 12 bits, (T - 400) in 0.1degC
+ *   H: relative humidity in %
+ *   S: average wind speed in 0.34m/s steps
+ *   G: gust wind speed in 0.34m/s steps
+ *   R: rain bucket tip counter, 12 bits, 0.3mm per tip
+ *   B: battery/status flags
+ *   D: wind direction, 0-15 in 22.5 degree steps
+ *   C: CRC-8, polynomial 0x31, initial value 0x00
+ *
+ * This file has no AVR dependencies so that it can also be built on the host
+ * against the benchmark corpus in wh1080/host.
+ */
+
+#ifndef __WH1080_H__
+#define __WH1080_H__
+
+#include <stdint.h>
+
+/* Length of a weather frame in bytes, excluding the preamble */
+#define WH1080_FRAME_LEN    10
+
+/* Message type nibble for weather data */
+#define WH1080_TYPE_WEATHER 0xA
+
+/* Limits on run lengths, in 250us chips */
+#define WH1080_SHORT_MAX    3   /* A pulse of 1-3 chips is a '1' (nominal 2) */
+#define WH1080_LONG_MAX     8   /* A pulse of 4-8 chips is a '0' (nominal 6) */
+#define WH1080_GAP_MIN      2   /* Gaps between pulses are nominally 4 chips */
+#define WH1080_GAP_MAX      7
+
+/* Return values from wh1080_chips() */
+#define WH1080_MORE         0
+#define WH1080_DONE         1
+#define WH1080_ERROR        -1
+
+/* The most recently decoded frame */
+extern uint8_t wh1080_frame[WH1080_FRAME_LEN];
+
+void wh1080_reset(void);
+int8_t wh1080_chips(uint8_t chips);
+
+#endif /* __WH1080_H__ */
@@ -0,0 +1,108 @@
+/**
+ * Decode rate, false-accept rate and throughput of the WH1080 decoders.
+ *
+ * Runs both the host Decoder and the firmware's own wh1080.c over a corpus
+ * of synthetic captures through the same sync search the RFM69 does, and
+ * reports for each capture how many of the transmitted frames came out,
+ * how many frames came out that were never sent, and how fast.
+ *
+ * Usage: wh1080-bench [corpus file]
+ * Without a corpus file the standard corpus is generated in memory.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "generator.hpp"
+#include "wh1080.hpp"
+
+extern "C" {
+#include "../firmware/wh1080.h"
+}
+
+using namespace wh1080;
+
+/**
+ * Adapter so the firmware decoder can go through wh1080::receive().
+ */
+struct FirmwareDecoder {
+    Frame f;
+
+    void reset() { wh1080_reset(); }
+
+    int push(uint8_t chips)
+    {
+        int r = wh1080_chips(chips);
+        if(r == WH1080_DONE)
+            std::memcpy(f.data(), wh1080_frame, FRAME_LEN);
+        return r;
+    }
+
+    const Frame& frame() const { return f; }
+};
+
+template <typename D>
+static void run(const char* name, const Capture& c, D& dec)
+{
+    std::vector<Frame> got;
+    got.reserve(c.sent.size() + 16);
+
+    auto t0 = std::chrono::steady_clock::now();
+    receive(c.chips, dec, got);
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    /* Frames are random so a match in the sent list is a correct decode */
+    std::vector<Frame> sent(c.sent);
+    std::sort(sent.begin(), sent.end());
+    unsigned good = 0, bad = 0;
+    for(const Frame& f : got)
+    {
+        if(std::binary_search(sent.begin(), sent.end(), f))
+            good++;
+        else
+            bad++;
+    }
+
+    /* Air time of the capture at 4000 chips/s */
+    double hours = c.chips.size() / 4000.0 / 3600.0;
+
+    std::printf("%-9s %8.4f %6u %6u %7.2f%% %6u %9.3f %9.1f\n",
+            name, c.channel.flip * 100.0, c.channel.jitter,
+            (unsigned)c.sent.size(),
+            c.sent.empty() ? 0.0 : 100.0 * good / c.sent.size(),
+            bad, bad / hours, c.chips.size() / secs / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<Capture> corpus;
+
+    if(argc > 1)
+    {
+        if(!read_corpus(argv[1], corpus))
+        {
+            std::fprintf(stderr, "Could not read corpus %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        corpus = standard_corpus(1080, 2000);
+    }
+
+    std::printf("%-9s %8s %6s %6s %8s %6s %9s %9s\n", "decoder", "flip%",
+            "jit_us", "sent", "decoded", "false", "false/h", "Mchip/s");
+
+    for(const Capture& c : corpus)
+    {
+        Decoder host;
+        FirmwareDecoder fw;
+        run("host", c, host);
+        run("firmware", c, fw);
+    }
+
+    return 0;
+}
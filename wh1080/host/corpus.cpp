@@ -0,0 +1,30 @@
+/**
+ * Write the standard WH1080 benchmark corpus to a file.
+ *
+ * Usage: wh1080-corpus <file> [seed] [frames per capture]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "generator.hpp"
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <file> [seed] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t seed = argc > 2 ? (uint32_t)std::strtoul(argv[2], NULL, 0) : 1080;
+    unsigned frames = argc > 3 ? (unsigned)std::strtoul(argv[3], NULL, 0) : 2000;
+
+    if(!wh1080::write_corpus(argv[1], wh1080::standard_corpus(seed, frames)))
+    {
+        std::fprintf(stderr, "Could not write %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * Synthetic WH1080 transmissions for exercising the decoders.
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+#include "generator.hpp"
+
+namespace wh1080 {
+
+/* Corpus file magic and version */
+static const char CORPUS_MAGIC[4] = { 'W', 'H', 'C', '1' };
+
+Reading Generator::reading()
+{
+    std::uniform_int_distribution<int> u8(0, 255);
+    Reading r;
+
+    r.station_id = (uint8_t)u8(rng_);
+    r.temperature = (int16_t)std::uniform_int_distribution<int>(-200, 400)(rng_);
+    r.humidity = (uint8_t)std::uniform_int_distribution<int>(10, 99)(rng_);
+    r.wind_avg = (uint8_t)std::uniform_int_distribution<int>(0, 60)(rng_);
+    r.wind_gust = (uint8_t)(r.wind_avg + std::uniform_int_distribution<int>(0, 30)(rng_));
+    r.rain = (uint16_t)std::uniform_int_distribution<int>(0, 4095)(rng_);
+    r.direction = (uint8_t)(u8(rng_) & 0x0F);
+    r.status = 0;
+
+    return r;
+}
+
+double Generator::jittered(double nominal, unsigned jitter)
+{
+    if(!jitter)
+        return nominal;
+
+    return nominal + std::uniform_real_distribution<double>(-(double)jitter, jitter)(rng_);
+}
+
+void Generator::modulate(const Frame& f, unsigned jitter, std::vector<uint8_t>& chips)
+{
+    /* Time of the next chip sample relative to the start of the preamble */
+    double sample = std::uniform_real_distribution<double>(0.0, CHIP_US)(rng_);
+    double t = 0.0;
+
+    /* 0xFF preamble then the frame, MSB first */
+    for(std::size_t i = 0; i <= FRAME_LEN; i++)
+    {
+        uint8_t byte = i ? f[i - 1] : 0xFF;
+
+        for(int b = 7; b >= 0; b--)
+        {
+            double edge = t + jittered((byte >> b) & 0x01 ? PULSE_SHORT_US : PULSE_LONG_US, jitter);
+            t += ((byte >> b) & 0x01 ? PULSE_SHORT_US : PULSE_LONG_US) + GAP_US;
+
+            for(; sample < edge; sample += CHIP_US)
+                chips.push_back(1);
+            for(; sample < t; sample += CHIP_US)
+                chips.push_back(0);
+        }
+    }
+}
+
+void Generator::interference(std::size_t n, std::vector<uint8_t>& chips)
+{
+    /* Runs of the same sort of length as real pulses are the worst case */
+    std::uniform_int_distribution<unsigned> len(1, 10);
+    uint8_t level = 0;
+
+    while(n)
+    {
+        unsigned l = len(rng_);
+        if(l > n)
+            l = (unsigned)n;
+        chips.insert(chips.end(), l, level);
+        level ^= 1;
+        n -= l;
+    }
+}
+
+void Generator::flip(double p, std::vector<uint8_t>& chips)
+{
+    if(p <= 0.0)
+        return;
+
+    /* Skip straight to the next error rather than rolling for every chip */
+    std::geometric_distribution<std::size_t> gap(p);
+    for(std::size_t i = gap(rng_); i < chips.size(); i += gap(rng_) + 1)
+        chips[i] ^= 1;
+}
+
+Capture Generator::capture(unsigned frames, const Channel& ch)
+{
+    Capture c;
+    c.channel = ch;
+
+    for(unsigned i = 0; i < frames; i++)
+    {
+        interference(ch.noise_chips, c.chips);
+        /* Quiet before the preamble while the station keys up */
+        c.chips.insert(c.chips.end(), 40, 0);
+
+        Frame f = encode(reading());
+        c.sent.push_back(f);
+        modulate(f, ch.jitter, c.chips);
+        c.chips.insert(c.chips.end(), 40, 0);
+    }
+    interference(ch.noise_chips, c.chips);
+    flip(ch.flip, c.chips);
+
+    return c;
+}
+
+Capture Generator::noise(std::size_t chips, const Channel& ch)
+{
+    Capture c;
+    c.channel = ch;
+    interference(chips, c.chips);
+    flip(ch.flip, c.chips);
+    return c;
+}
+
+std::vector<Capture> standard_corpus(uint32_t seed, unsigned frames)
+{
+    static const double flips[] = { 0.0, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05 };
+    Generator g(seed);
+    std::vector<Capture> corpus;
+
+    for(double p : flips)
+        corpus.push_back(g.capture(frames, Channel(p, 100)));
+
+    /* About three and a half hours at 4kbps of nothing but interference */
+    corpus.push_back(g.noise(50000000, Channel(0.0, 0)));
+
+    return corpus;
+}
+
+static bool put32(std::FILE* fp, uint32_t v)
+{
+    uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    return std::fwrite(b, 1, 4, fp) == 4;
+}
+
+static bool get32(std::FILE* fp, uint32_t* v)
+{
+    uint8_t b[4];
+    if(std::fread(b, 1, 4, fp) != 4)
+        return false;
+    *v = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+    return true;
+}
+
+bool write_corpus(const std::string& path, const std::vector<Capture>& corpus)
+{
+    std::FILE* fp = std::fopen(path.c_str(), "wb");
+    if(!fp)
+        return false;
+
+    bool ok = std::fwrite(CORPUS_MAGIC, 1, 4, fp) == 4
+        && put32(fp, (uint32_t)corpus.size());
+
+    for(const Capture& c : corpus)
+    {
+        if(!ok)
+            break;
+
+        /* Chip error rate is stored in parts per million */
+        ok = put32(fp, (uint32_t)(c.channel.flip * 1e6 + 0.5))
+            && put32(fp, c.channel.jitter)
+            && put32(fp, c.channel.noise_chips)
+            && put32(fp, (uint32_t)c.sent.size())
+            && put32(fp, (uint32_t)c.chips.size());
+
+        for(const Frame& f : c.sent)
+            ok = ok && std::fwrite(f.data(), 1, FRAME_LEN, fp) == FRAME_LEN;
+
+        /* Chips packed eight to a byte, MSB first */
+        std::vector<uint8_t> packed((c.chips.size() + 7) / 8, 0);
+        for(std::size_t i = 0; i < c.chips.size(); i++)
+            packed[i >> 3] |= (uint8_t)(c.chips[i] << (7 - (i & 7)));
+        ok = ok && std::fwrite(packed.data(), 1, packed.size(), fp) == packed.size();
+    }
+
+    return std::fclose(fp) == 0 && ok;
+}
+
+bool read_corpus(const std::string& path, std::vector<Capture>& corpus)
+{
+    std::FILE* fp = std::fopen(path.c_str(), "rb");
+    char magic[4];
+    uint32_t n, ppm, jitter, noise, nsent, nchips;
+    bool ok;
+
+    if(!fp)
+        return false;
+
+    ok = std::fread(magic, 1, 4, fp) == 4
+        && std::equal(magic, magic + 4, CORPUS_MAGIC)
+        && get32(fp, &n);
+
+    for(uint32_t i = 0; ok && i < n; i++)
+    {
+        ok = get32(fp, &ppm) && get32(fp, &jitter) && get32(fp, &noise)
+            && get32(fp, &nsent) && get32(fp, &nchips);
+        if(!ok)
+            break;
+
+        Capture c;
+        c.channel = Channel(ppm / 1e6, jitter, noise);
+        c.sent.resize(nsent);
+        for(Frame& f : c.sent)
+            ok = ok && std::fread(f.data(), 1, FRAME_LEN, fp) == FRAME_LEN;
+
+        std::vector<uint8_t> packed((nchips + 7) / 8);
+        ok = ok && std::fread(packed.data(), 1, packed.size(), fp) == packed.size();
+        c.chips.resize(nchips);
+        for(std::size_t k = 0; k < nchips; k++)
+            c.chips[k] = (packed[k >> 3] >> (7 - (k & 7))) & 0x01;
+
+        corpus.push_back(std::move(c));
+    }
+
+    std::fclose(fp);
+    return ok;
+}
+
+} // namespace wh1080
@@ -0,0 +1,101 @@
+/**
+ * Synthetic WH1080 transmissions for exercising the decoders.
+ *
+ * Frames are modulated into the chip stream the RFM69 would produce in the
+ * bridge's OOK profile (250us chips), with timing jitter, random chip errors
+ * and pulse-like interference between frames.
+ */
+
+#ifndef WH1080_GENERATOR_HPP
+#define WH1080_GENERATOR_HPP
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "wh1080.hpp"
+
+namespace wh1080 {
+
+/** Chip period of the bridge's OOK profile in microseconds */
+const double CHIP_US = 250.0;
+
+/** Nominal pulse and gap lengths sent by the station in microseconds */
+const double PULSE_SHORT_US = 544.0;
+const double PULSE_LONG_US = 1524.0;
+const double GAP_US = 1000.0;
+
+/**
+ * Impairments applied to a capture.
+ */
+struct Channel {
+    double flip;            /**< Probability that any one chip is inverted */
+    unsigned jitter;        /**< Each edge moves by up to this many microseconds */
+    unsigned noise_chips;   /**< Chips of interference between frames */
+
+    Channel(double f = 0.0, unsigned j = 0, unsigned n = 4000)
+        : flip(f), jitter(j), noise_chips(n) {}
+};
+
+/**
+ * A chip stream and the frames that were modulated into it.
+ */
+struct Capture {
+    Channel channel;
+    std::vector<Frame> sent;
+    std::vector<uint8_t> chips;     /**< One chip per element, 0 or 1 */
+};
+
+class Generator {
+public:
+    explicit Generator(uint32_t seed) : rng_(seed) {}
+
+    /** A random but plausible reading */
+    Reading reading();
+
+    /**
+     * Append the preamble and PWM bits of a frame. Edges are placed in
+     * continuous time, moved by up to jitter microseconds, then sampled at
+     * the chip rate with a random phase as the RFM69 would.
+     */
+    void modulate(const Frame& f, unsigned jitter, std::vector<uint8_t>& chips);
+
+    /** Append pulse-like interference with random run lengths */
+    void interference(std::size_t n, std::vector<uint8_t>& chips);
+
+    /** Invert each chip with the given probability */
+    void flip(double p, std::vector<uint8_t>& chips);
+
+    /** A capture of the given number of frames separated by interference */
+    Capture capture(unsigned frames, const Channel& ch);
+
+    /** A capture of nothing but interference, for false-accept testing */
+    Capture noise(std::size_t chips, const Channel& ch);
+
+private:
+    double jittered(double nominal, unsigned jitter);
+
+    std::mt19937 rng_;
+};
+
+/**
+ * Save captures to a corpus file.
+ * @returns false on an I/O error
+ */
+bool write_corpus(const std::string& path, const std::vector<Capture>& corpus);
+
+/**
+ * Load captures from a file written by write_corpus().
+ * @returns false on an I/O error or if the file is not a corpus
+ */
+bool read_corpus(const std::string& path, std::vector<Capture>& corpus);
+
+/**
+ * The standard corpus: a sweep of chip error rates with a fixed amount of
+ * jitter, plus a long stretch of interference with no frames at all.
+ */
+std::vector<Capture> standard_corpus(uint32_t seed, unsigned frames);
+
+} // namespace wh1080
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * Host-side decoder for Fine Offset WH1080 weather station frames.
+ */
+
+#include "wh1080.hpp"
+
+namespace wh1080 {
+
+bool Reading::operator==(const Reading& o) const
+{
+    return station_id == o.station_id && temperature == o.temperature
+        && humidity == o.humidity && wind_avg == o.wind_avg
+        && wind_gust == o.wind_gust && rain == o.rain
+        && direction == o.direction && status == o.status;
+}
+
+uint8_t crc8(const uint8_t* data, std::size_t len)
+{
+    uint8_t crc = 0;
+
+    while(len--)
+    {
+        crc ^= *data++;
+        for(unsigned i = 0; i < 8; i++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+Frame encode(const Reading& r)
+{
+    Frame f;
+    uint16_t t = (uint16_t)(r.temperature + 400) & 0x0FFF;
+
+    f[0] = (TYPE_WEATHER << 4) | (r.station_id >> 4);
+    f[1] = (uint8_t)(r.station_id << 4) | (t >> 8);
+    f[2] = t & 0xFF;
+    f[3] = r.humidity;
+    f[4] = r.wind_avg;
+    f[5] = r.wind_gust;
+    f[6] = (r.rain >> 8) & 0x0F;
+    f[7] = r.rain & 0xFF;
+    f[8] = (uint8_t)(r.status << 4) | (r.direction & 0x0F);
+    f[9] = crc8(f.data(), FRAME_LEN - 1);
+
+    return f;
+}
+
+bool parse(const Frame& f, Reading* r)
+{
+    if((f[0] >> 4) != TYPE_WEATHER || crc8(f.data(), FRAME_LEN - 1) != f[9])
+        return false;
+
+    r->station_id = (uint8_t)((f[0] << 4) | (f[1] >> 4));
+    r->temperature = (int16_t)(((f[1] & 0x0F) << 8) | f[2]) - 400;
+    r->humidity = f[3];
+    r->wind_avg = f[4];
+    r->wind_gust = f[5];
+    r->rain = (uint16_t)(((f[6] & 0x0F) << 8) | f[7]);
+    r->direction = f[8] & 0x0F;
+    r->status = f[8] >> 4;
+
+    return true;
+}
+
+Decoder::Decoder(const Timing& t) : timing_(t)
+{
+    reset();
+}
+
+void Decoder::reset()
+{
+    run_ = 0;
+    level_ = 0;
+    nbits_ = 0;
+    hunting_ = true;
+    crc_ = 0;
+}
+
+Decoder::Status Decoder::bit(unsigned b)
+{
+    if(hunting_)
+    {
+        /* Preamble is all ones and the type nibble starts 10 */
+        if(b)
+            return MORE;
+        hunting_ = false;
+        bit(1);
+    }
+
+    uint8_t& byte = frame_[nbits_ >> 3];
+    byte = (uint8_t)((byte << 1) | b);
+
+    if(((crc_ >> 7) ^ b) & 0x01)
+        crc_ = (uint8_t)((crc_ << 1) ^ 0x31);
+    else
+        crc_ = (uint8_t)(crc_ << 1);
+
+    if(++nbits_ < FRAME_LEN * 8)
+        return MORE;
+
+    if(crc_ || (frame_[0] >> 4) != TYPE_WEATHER)
+        return ERROR;
+
+    return DONE;
+}
+
+Decoder::Status Decoder::push(uint8_t chips)
+{
+    for(unsigned i = 0; i < 8; i++, chips <<= 1)
+    {
+        unsigned c = (chips >> 7) & 0x01;
+
+        if(c == level_)
+        {
+            run_++;
+            if(run_ > (level_ ? timing_.long_max : timing_.gap_max))
+                return ERROR;
+            continue;
+        }
+
+        if(level_)
+        {
+            Status r = bit(run_ <= timing_.short_max);
+            if(r != MORE)
+                return r;
+        }
+        else if(run_ < timing_.gap_min && !hunting_)
+        {
+            return ERROR;
+        }
+
+        level_ ^= 1;
+        run_ = 1;
+    }
+
+    return MORE;
+}
+
+} // namespace wh1080
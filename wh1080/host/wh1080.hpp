@@ -0,0 +1,151 @@
+/**
+ * Host-side decoder for Fine Offset WH1080 weather station frames.
+ *
+ * This mirrors the streaming decoder in ../firmware/wh1080.c but with the
+ * slicer limits as parameters, so that changes can be tried out against the
+ * corpus from generator.hpp before they go anywhere near the ATtiny13. See
+ * ../firmware/wh1080.h for the frame layout.
+ */
+
+#ifndef WH1080_HPP
+#define WH1080_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wh1080 {
+
+/** Length of a weather frame in bytes, excluding the preamble */
+const std::size_t FRAME_LEN = 10;
+
+/** Message type nibble for weather data */
+const uint8_t TYPE_WEATHER = 0xA;
+
+typedef std::array<uint8_t, FRAME_LEN> Frame;
+
+/**
+ * The fields of a weather frame, in the units the station sends them.
+ */
+struct Reading {
+    uint8_t station_id;
+    int16_t temperature;    /**< 0.1degC */
+    uint8_t humidity;       /**< % relative humidity */
+    uint8_t wind_avg;       /**< 0.34m/s steps */
+    uint8_t wind_gust;      /**< 0.34m/s steps */
+    uint16_t rain;          /**< Bucket tips, 0.3mm each, 12 bits */
+    uint8_t direction;      /**< 0-15, 22.5 degree steps */
+    uint8_t status;         /**< Battery and status flags, 4 bits */
+
+    double temperature_c() const { return temperature / 10.0; }
+    double wind_avg_ms() const { return wind_avg * 0.34; }
+    double wind_gust_ms() const { return wind_gust * 0.34; }
+    double rain_mm() const { return rain * 0.3; }
+    double bearing() const { return direction * 22.5; }
+
+    bool operator==(const Reading& o) const;
+};
+
+/**
+ * CRC-8 with polynomial 0x31 and initial value 0, as used by the station.
+ */
+uint8_t crc8(const uint8_t* data, std::size_t len);
+
+/**
+ * Pack a reading into a frame, including the type nibble and CRC.
+ */
+Frame encode(const Reading& r);
+
+/**
+ * Check the type and CRC of a frame and unpack its fields.
+ * @returns false if the frame is not a valid weather frame
+ */
+bool parse(const Frame& f, Reading* r);
+
+/**
+ * Limits on run lengths accepted by the slicer, in 250us chips.
+ */
+struct Timing {
+    unsigned short_max;     /**< Longest pulse that is still a '1' */
+    unsigned long_max;      /**< Longest pulse that is still a '0' */
+    unsigned gap_min;       /**< Shortest gap between pulses */
+    unsigned gap_max;       /**< Longest gap between pulses */
+
+    Timing() : short_max(3), long_max(8), gap_min(2), gap_max(7) {}
+};
+
+/**
+ * Streaming chip slicer and frame assembler.
+ *
+ * Chips are pushed in eight at a time, oldest in the MSB, exactly as the
+ * bridge reads them out of the RFM69 FIFO after a sync match.
+ */
+class Decoder {
+public:
+    enum Status { MORE = 0, DONE = 1, ERROR = -1 };
+
+    explicit Decoder(const Timing& t = Timing());
+
+    void reset();
+    Status push(uint8_t chips);
+
+    /** The frame assembled so far, valid once push() returns DONE */
+    const Frame& frame() const { return frame_; }
+
+private:
+    Status bit(unsigned b);
+
+    Timing timing_;
+    Frame frame_;
+    unsigned run_;
+    unsigned level_;
+    unsigned nbits_;
+    bool hunting_;
+    uint8_t crc_;
+};
+
+/**
+ * Stand-in for the RFM69 packet engine in the OOK profile: search a chip
+ * stream for the preamble sync word with the same bit error tolerance the
+ * radio is configured with, then hand the following chips a byte at a time
+ * to a decoder until it finishes or gives up, and search again.
+ *
+ * @param chips One chip per element, 0 or 1
+ * @param dec Anything with reset(), push(uint8_t) and frame() like Decoder
+ * @param out Every frame for which the decoder returned DONE
+ */
+template <typename D>
+void receive(const std::vector<uint8_t>& chips, D& dec, std::vector<Frame>& out)
+{
+    const uint32_t sync = 0xC30C30;     // 110000 x 4
+    const unsigned tolerance = 2;
+    uint32_t reg = 0;
+    std::size_t i = 0;
+    const std::size_t n = chips.size();
+
+    while(i < n)
+    {
+        reg = ((reg << 1) | chips[i++]) & 0xFFFFFF;
+        if(__builtin_popcount(reg ^ sync) > (int)tolerance)
+            continue;
+
+        dec.reset();
+        while(i + 8 <= n)
+        {
+            uint8_t b = 0;
+            for(unsigned k = 0; k < 8; k++)
+                b = (b << 1) | chips[i++];
+            int r = dec.push(b);
+            if(r == Decoder::DONE)
+                out.push_back(dec.frame());
+            if(r != Decoder::MORE)
+                break;
+        }
+        reg = 0;
+    }
+}
+
+} // namespace wh1080
+
+#endif